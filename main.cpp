@@ -36,14 +36,31 @@
 #include <ga/std_stream.h>
 #include <iostream>
 #include <sstream>
+#include <chrono>
 #include "model/GAChromosom.h"
 #include "model/NSGAII.h"
 #include "model/Population.h"
 #include "model/Model.h"
 #include "utils/CommandLine.h"
+#include "utils/Random.h"
+#include "utils/Directory.h"
+#include "utils/LogSink.h"
+#include "utils/PerfCounters.h"
+#include "utils/Probes.h"
+#include "utils/Scratch.h"
+#include "utils/Sweep.h"
+#include "utils/ThreadPool.h"
 #include <sys/stat.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <map>
+#include <thread>
 
 using namespace std;
 
@@ -53,68 +70,95 @@ int main2(int argc, char* argv[]) {
 	return 0;
 }
 
-int main(int argc, char* argv[]) {
-  /* Configure CLI */
-  CommandLine cl("mdea");
-  cl.addOption("-in","-in <models directory>");
-  cl.addOption("-out","-out <output directory>",false);
-  cl.addOption("-nb","-nb <number of model in a single chromosom>",false);
-  //  cl.addOption("-cfg","-cfg <config file>",false);
-  // TODO: Add possibility to create a config file for inputs  
-  cl.addOption("-m","-m <percentage of mutation chance>",false);
-  cl.addOption("-dist","-dist <cosine|levenshtein|smartLevenshtein|hamming|centrality>",false);
-  cl.addOption("-g","-g <number of generations>",false);
-  cl.addOption("-cx","-cx <inter|intra>",false);
-  cl.addOption("-fitness","-fitness <min|avg|minavg|minavgs|dist>",false);
-  cl.addOption("-freq","-freq <dot files generation frequency in addition to the last generation, 0 = only last generation>, -1 = no generation",false);
+namespace {
+  typedef std::map<std::string,std::string> Options;
 
-  /* Parse CLI input */
-  auto opt = cl.parse(argc,argv);
-
-  auto pm = 1u; //< Multiplier of population
-  // (On new generation, P -> P + pm*P)
-  
-  if(opt->at("-nb") == "") // Number of models in an individual
-    Chromosom::setNbModels(2);
-  else
-    Chromosom::setNbModels(std::stof(opt->at("-nb")));
-
-  // In the case m = 1, crossover are necessary intra.
-  if(Chromosom::getNbModels() == 1) {
-    GAChromosom::crossover = GAChromosom::Cross::INTRA;
-    pm = 1; // TODO: Do not hardcode this value.
+  /* Options of a run, shared by mdea and mdea sweep */
+  void addRunOptions(CommandLine& cl) {
+    cl.addOption("-out","-out <output directory>",false);
+    cl.addOption("-nb","-nb <number of model in a single chromosom>",false);
+    //  cl.addOption("-cfg","-cfg <config file>",false);
+    // TODO: Add possibility to create a config file for inputs  
+    cl.addOption("-m","-m <percentage of mutation chance>",false);
+    cl.addOption("-dist","-dist <cosine|levenshtein|smartLevenshtein|hamming|centrality>",false);
+    cl.addOption("-g","-g <number of generations>",false);
+    cl.addOption("-cx","-cx <inter|intra>",false);
+    cl.addOption("-fitness","-fitness <min|avg|minavg|minavgs|dist>",false);
+    cl.addOption("-freq","-freq <dot files generation frequency in addition to the last generation, 0 = only last generation>, -1 = no generation",false);
+    cl.addOption("-metrics","-metrics <csv|jsonl>",false);
+    cl.addOption("-converge","-converge <relative hypervolume improvement below which evolution stops, 0 = indicators only>",false);
+    cl.addOption("-window","-window <generations of the convergence test, default: 20>",false);
+    cl.addOption("-counters","-counters <on|off, hardware counters of phases in metrics>",false);
+    cl.addOption("-keyframe","-keyframe <keyframe interval of generation files, 1 = every generation>",false);
+    cl.addOption("-seed","-seed <run seed, recorded in output directory>",false);
   }
-  
 
+  /* Set the static configuration of a run (once per process), return
+     false if no distance is given */
+  bool configure(Options& opt, float& mut) {
+    if(opt.at("-nb") == "") // Number of models in an individual
+      Chromosom::setNbModels(2);
+    else
+      Chromosom::setNbModels(std::stof(opt.at("-nb")));
+
+    // In the case m = 1, crossover are necessary intra.
+    if(Chromosom::getNbModels() == 1)
+      GAChromosom::crossover = GAChromosom::Cross::INTRA;
   
-  if(opt->at("-cx") == "intra") // Are the crossover intra?
-    GAChromosom::crossover = GAChromosom::Cross::INTRA;
-
-  // Choice of fitness (default is each distance is a fitness)
-  if(opt->at("-fitness") == "min") 
-    NSGAII::fitness = NSGAII::Fitness::MIN;
-  if(opt->at("-fitness") == "avg")
-    NSGAII::fitness = NSGAII::Fitness::AVG;
-  if(opt->at("-fitness") == "minavgs")
-    NSGAII::fitness = NSGAII::Fitness::MINAVG;
-  if(opt->at("-fitness") == "minavg")
-    NSGAII::fitness = NSGAII::Fitness::AVG | NSGAII::Fitness::MIN;
-
-  // Mutation percentage chance
-  auto mut = 0.f;
-  if(opt->at("-m") != "")
-    mut = std::stof(opt->at("-m"));
-    
+    if(opt.at("-cx") == "intra") // Are the crossover intra?
+      GAChromosom::crossover = GAChromosom::Cross::INTRA;
+
+    // Choice of fitness (default is each distance is a fitness)
+    if(opt.at("-fitness") == "min") 
+      NSGAII::fitness = NSGAII::Fitness::MIN;
+    if(opt.at("-fitness") == "avg")
+      NSGAII::fitness = NSGAII::Fitness::AVG;
+    if(opt.at("-fitness") == "minavgs")
+      NSGAII::fitness = NSGAII::Fitness::MINAVG;
+    if(opt.at("-fitness") == "minavg")
+      NSGAII::fitness = NSGAII::Fitness::AVG | NSGAII::Fitness::MIN;
+
+    // Mutation percentage chance
+    mut = 0.f;
+    if(opt.at("-m") != "")
+      mut = std::stof(opt.at("-m"));
+
+    // Run seed: every random stream (crossover, mutation, clustering)
+    // is derived from it, GAlib selection is seeded from it too.
+    if(opt.at("-seed") != "")
+      Random::seed(std::stoull(opt.at("-seed")));
+    else
+      Random::seed(Random::makeSeed());
+    GARandomSeed(static_cast<unsigned int>(Random::seed() % 2147483646) + 1);
 
+    // Number of generations
+    NSGAII::maxGen = 100;
+    if(opt.at("-g") != "")
+      NSGAII::maxGen = std::stof(opt.at("-g"));
 
-  // Number of generations
-  NSGAII::maxGen = 100;
-  if(opt->at("-g") != "")
-    NSGAII::maxGen = std::stof(opt->at("-g"));
+    // Generation files between keyframes are deltas
+    if(opt.at("-keyframe") != "")
+      NSGAII::keyframe = std::stoul(opt.at("-keyframe"));
+
+    // Format of per generation performance metrics
+    if(opt.at("-metrics") == "jsonl")
+      NSGAII::metricsFormat = GenerationMetrics::Format::JSONL;
+
+    // Hypervolume and IGD of each generation, and stop when the
+    // hypervolume no longer improves by epsilon over the window
+    if(opt.at("-converge") != "")
+      NSGAII::convergence = std::stod(opt.at("-converge"));
+    if(opt.at("-window") != "")
+      NSGAII::window = std::max(1ul, std::stoul(opt.at("-window")));
+
+    // Models of requested generations are exported during evolution
+    if(opt.at("-freq") != "")
+      NSGAII::exportFrequency = std::stoi(opt.at("-freq"));
   
-  // Choice of distance to use
-  auto method = opt->at("-dist");
-  if(method != "") {
+    // Choice of distance to use
+    auto method = opt.at("-dist");
+    if(method == "")
+      return false;
     std::stringstream split(method);
     std::string s;
     GAChromosom::method = 0;
@@ -130,100 +174,274 @@ int main(int argc, char* argv[]) {
       if(s == "cosine")
 	GAChromosom::method |= GAChromosom::Method::COSINE;
     }
+    return true;
   }
-  else{
-    cout << "pas de methode choisie" << endl;
-    exit(0);
-  }
-  
-  
-  
-  // Input population
-  auto pop = Population(opt->at("-in"));
-  
 
-  //output directory
-  if (opt->at("-out") != "")
-    NSGAII::dir = opt->at("-out");
-  else {
-    std::ostringstream dir;
-    dir << "output-"+opt->at("-in") << "-" << opt->at("-cx") << "-" << opt->at("-dist") << "-" << opt->at("-fitness") << "-" << opt->at("-g") << "-" << opt->at("-m") << "-" << opt->at("-nb");
-    NSGAII::dir = dir.str();
-  }
-  
+  /* Evolve a loaded population (configure must have been called) */
+  int run(Options& opt, Population& pop, long loadTime, float mut) {
+    auto pm = 1u; //< Multiplier of population
+    // (On new generation, P -> P + pm*P)
+
+    //output directory
+    if (opt.at("-out") != "")
+      NSGAII::dir = opt.at("-out");
+    else
+      NSGAII::dir = "output-"+Sweep::runName(opt);
   
-  system(("rm -rf "+NSGAII::dir).c_str());
-  mkdir(NSGAII::dir.c_str(),0777);
-  mkdir((NSGAII::dir+"/jvmconsuption").c_str(),0777);
-  mkdir((NSGAII::dir+"/output").c_str(),0777);
+    Directory::remove(NSGAII::dir);
+    mkdir(NSGAII::dir.c_str(),0777);
+    mkdir((NSGAII::dir+"/jvmconsuption").c_str(),0777);
+    mkdir((NSGAII::dir+"/output").c_str(),0777);
+    {
+      Logger seed(NSGAII::dir+"/seed");
+      seed << std::to_string(Random::seed()) << "\n";
+    }
+    {
+      // Load metrics: models, XCSP paths requested and files parsed,
+      // domains, variables, parse time (ms, summed over threads), load
+      // time
+      auto lm = Model::loadMetrics();
+      Logger load(NSGAII::dir+"/load");
+      load << "models files parsed domains variables parse_ms total_ms\n";
+      load << lm.requests << " " << lm.files << " " << lm.parsed << " "
+	   << lm.domains << " " << lm.variables << " " << lm.parseTime << " "
+	   << loadTime << "\n";
+      std::cout << "Loaded " << pop.size() << " chromosoms (" << lm.requests
+		<< " models, " << lm.parsed << " XCSP parsed) in " << loadTime
+		<< " ms" << std::endl;
+    }
   
-  std::ostringstream oss;
-  oss << NSGAII::dir << "/stat";
-  Statistics::outfile = oss.str();
-
-  // Evaluation of initial population
-  if(GAChromosom::getNbModels() != 1)
-    pop.evaluate();
-  else
-    pop.popEvaluate();
+    // Hardware counters of the phases of generations, in metrics
+    if(opt.at("-counters") == "on" && !PerfCounters::enable())
+      std::cerr << "Hardware counters unavailable (" << PerfCounters::error()
+		<< "), metrics are recorded without them" << std::endl;
+
+    std::ostringstream oss;
+    oss << NSGAII::dir << "/stat";
+    Statistics::outfile = oss.str();
+
+    // Evaluation of initial population
+    {
+      PROBE_TIMER("initial evaluation");
+      if(GAChromosom::getNbModels() != 1)
+	pop.evaluate();
+      else
+	pop.popEvaluate();
+    }
     
-  
-  // Initialize algorithm
-  GAChromosom genome;
-  GAParameterList params;
-  NSGAII ga(pop,pm);
-  GASteadyStateGA::registerDefaultParameters(params);
-  params.set(gaNflushFrequency, 10);
-  params.set(gaNnGenerations, NSGAII::maxGen);
-  params.set(gaNpConvergence,0.99);
-  params.set(gaNnConvergence,100);
-  params.set(gaNpMutation,mut);
-  params.set(gaNpCrossover,1);
-  params.set(gaNscoreFrequency,1);
-  params.set(gaNselectScores,GAStatistics::Maximum|GAStatistics::Minimum|GAStatistics::Mean);
-  params.set(gaNpopulationSize,pop.size());
-  params.set(gaNscoreFilename,Statistics::outfile.c_str());
-  ga.parameters(params);
-
-  // Set selector type (NSGA-II algorithm uses tournament selector)
-  ga.selector(GATournamentSelector());
-  
-  // ga.terminator(GAGeneticAlgorithm::TerminateUponConvergence);
-  // ^ Uncomment this line to terminate upon convergence.
+    // Initialize algorithm
+    GAChromosom genome;
+    GAParameterList params;
+    NSGAII ga(pop,pm);
+    GASteadyStateGA::registerDefaultParameters(params);
+    params.set(gaNflushFrequency, 10);
+    params.set(gaNnGenerations, NSGAII::maxGen);
+    params.set(gaNpConvergence,0.99);
+    params.set(gaNnConvergence,100);
+    params.set(gaNpMutation,mut);
+    params.set(gaNpCrossover,1);
+    params.set(gaNscoreFrequency,1);
+    params.set(gaNselectScores,GAStatistics::Maximum|GAStatistics::Minimum|GAStatistics::Mean);
+    params.set(gaNpopulationSize,pop.size());
+    params.set(gaNscoreFilename,Statistics::outfile.c_str());
+    ga.parameters(params);
 
-	std::cout << ga << std::endl;
-  // do the evolution
-  ga.evolve();
+    // Set selector type (NSGA-II algorithm uses tournament selector)
+    ga.selector(GATournamentSelector());
   
-  
-  
-  //generate all dot files
-  
-  int frequency = -1;
-  if(opt->at("-freq") != ""){
-  	frequency = std::stoi(opt->at("-freq"));
+    // GAlib convergence is measured on scalar scores: the evolution
+    // stops upon convergence of the fronts instead (see -converge)
+    if(NSGAII::convergence >= 0 && GAChromosom::getNbModels() == 1)
+      std::cerr << "Indicators need fronts of models (-nb > 1), -converge is ignored"
+		<< std::endl;
+
+    std::cout << ga << std::endl;
+    // do the evolution
+    ga.evolve();
+
+    // print out the results
+    cout << ga.statistics() << endl;
+
+    // Print statistics in the outfile
+    std::string outfile = Statistics::outfile;
+    Logger l(outfile);
+    l << ga.extraStatistics();
+
+    // Timers, counters and histograms of the run
+    Probes::merge();
+    std::cout << Probes::summary();
+    return 0;
   }
-  
-  if(frequency>0){
-		for(int i =1; i<=NSGAII::maxGen; i++){
-			if((i % (std::stoi(opt->at("-freq")))==0) || i==NSGAII::maxGen){
-				ga.generateDotGen(opt->at("-in"),NSGAII::dir+"/output/gen"+std::to_string(i),NSGAII::dir+"/output/dotgen"+std::to_string(i));
-			}
-		}
+
+  /* Run of a sweep configuration, in a forked process */
+  int sweepRun(Options opt, const std::string& name, const std::vector<Model>& corpus,
+	       long loadTime, const std::string& logDir) {
+    auto status = 1;
+    try {
+      auto t = std::chrono::high_resolution_clock::now();
+      auto fd = open((logDir+"/"+name+".txt").c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0666);
+      if(fd >= 0) {
+	dup2(fd, 1);
+	dup2(fd, 2);
+	close(fd);
+      }
+      opt["-out"] = (opt.at("-out") != "") ? opt.at("-out")+"/"+name : name;
+      float mut;
+      configure(opt, mut);
+      Population pop(corpus);
+      status = run(opt, pop, loadTime, mut);
+      std::cout << "Elapsed " << std::chrono::duration_cast<std::chrono::milliseconds>
+	(std::chrono::high_resolution_clock::now()-t).count() << " ms" << std::endl;
+    } catch(std::exception& e) {
+      std::cerr << "Error: " << e.what() << std::endl;
+    }
+    LogSink::instance().flush();
+    std::cout.flush();
+    fflush(nullptr);
+    return status;
   }
-  if(frequency==0){
-  	ga.generateDotGen(opt->at("-in"),NSGAII::dir+"/output/gen"+std::to_string(NSGAII::maxGen),NSGAII::dir+"/output/dotgen"+std::to_string(NSGAII::maxGen));
+
+  /* mdea sweep: every combination of comma separated option values,
+     run in forked processes sharing the loaded models */
+  int sweep(int argc, char* argv[]) {
+    CommandLine cl("mdea sweep");
+    cl.addOption("-in","-in <models directory>");
+    addRunOptions(cl);
+    cl.addOption("-jobs","-jobs <number of simultaneous runs, default: number of cores>",false);
+    cl.addOption("-log","-log <directory of run outputs, default: resultat_script>",false);
+    auto opt = cl.parse(argc,argv);
+
+    // Grid of configurations
+    const std::vector<std::string> grid =
+      {"-cx","-dist","-fitness","-g","-m","-nb","-seed","-keyframe","-metrics","-freq"};
+    auto configs = Sweep::expand(*opt, grid);
+    std::vector<std::string> names;
+    try {
+      names = Sweep::names(configs, grid);
+    } catch(std::exception& e) {
+      std::cerr << "Error: " << e.what() << std::endl;
+      delete opt;
+      return 1;
+    }
+    size_t cores = std::thread::hardware_concurrency();
+    if(!cores) cores = 1;
+    auto jobs = cores;
+    if(opt->at("-jobs") != "")
+      jobs = std::stoul(opt->at("-jobs"));
+    if(!jobs) jobs = 1;
+    auto logDir = (opt->at("-log") != "") ? opt->at("-log") : "resultat_script";
+    mkdir(logDir.c_str(),0777);
+    if(opt->at("-out") != "")
+      mkdir(opt->at("-out").c_str(),0777);
+    auto dots = false, norms = false;
+    for(auto& c : configs) {
+      if(c.at("-dist") == "") {
+	cout << "pas de methode choisie" << endl;
+	delete opt;
+	return 0;
+      }
+      for(auto& d : Sweep::explode(c.at("-dist"), '+')) {
+	dots |= (d == "hamming" || d == "centrality" || d == "smartLevenshtein");
+	norms |= (d == "cosine");
+      }
+    }
+
+    // Models are loaded once, and their dot files and norms computed
+    // once: runs share them through the copies of their genes
+    // (tool consumption of this first generation goes to the log directory)
+    NSGAII::dir = logDir;
+    if(dots)
+      mkdir((logDir+"/jvmconsuption").c_str(),0777);
+    auto tload = std::chrono::high_resolution_clock::now();
+    auto corpus = Population::loadModels(opt->at("-in"));
+    ThreadPool::instance().parallelFor(corpus.size(), [&](size_t i) {
+	if(dots) corpus[i].generateDotFile(0);
+	if(norms) corpus[i].squaredNorm();
+      });
+    auto loadTime = std::chrono::duration_cast<std::chrono::milliseconds>
+      (std::chrono::high_resolution_clock::now()-tload).count();
+    std::cout << "Loaded " << corpus.size() << " models in " << loadTime
+	      << " ms, " << configs.size() << " runs, " << jobs << " at a time"
+	      << std::endl;
+
+    // Runs share the scratch directory of the sweep: forked processes
+    // leave with _exit, so they would never remove their own
+    Scratch::directory();
+
+    std::map<pid_t,size_t> running;
+    std::vector<std::chrono::high_resolution_clock::time_point> started(configs.size());
+    size_t next = 0, finished = 0, failed = 0;
+    while(next < configs.size() || !running.empty()) {
+      if(next < configs.size() && running.size() < jobs) {
+	std::cout.flush();
+	fflush(nullptr);
+	started[next] = std::chrono::high_resolution_clock::now();
+	auto pid = fork();
+	if(pid == 0) {
+	  // Runs share the cores: jobs runs of cores/jobs workers
+	  ThreadPool::instanceSize(std::max<size_t>(1, cores/jobs));
+	  _exit(sweepRun(configs[next], names[next], corpus, loadTime, logDir));
+	}
+	if(pid < 0) {
+	  std::cerr << "Error: can not start " << names[next] << ": "
+		    << strerror(errno) << std::endl;
+	  finished++;
+	  failed++;
+	}
+	else running[pid] = next;
+	next++;
+	continue;
+      }
+      int status;
+      auto pid = waitpid(-1, &status, 0);
+      if(pid < 0) break;
+      auto it = running.find(pid);
+      if(it == running.end()) continue;
+      auto k = it->second;
+      running.erase(it);
+      auto ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+      failed += !ok;
+      std::cout << "[" << ++finished << "/" << configs.size() << "] "
+		<< names[k] << (ok ? " done in " : " failed after ")
+		<< std::chrono::duration_cast<std::chrono::milliseconds>
+	(std::chrono::high_resolution_clock::now()-started[k]).count()
+		<< " ms" << std::endl;
+    }
+    delete opt;
+    return failed ? 1 : 0;
   }
-  
+}
 
-  // print out the results
-  cout << ga.statistics() << endl;
+int main(int argc, char* argv[]) {
+  if(argc > 1 && std::string(argv[1]) == "sweep")
+    return sweep(argc-1, argv+1);
 
-  // Print statistics in the outfile
-  std::string outfile = Statistics::outfile;
-  Logger l(outfile);
-  l << ga.extraStatistics();
+  /* Configure CLI */
+  CommandLine cl("mdea");
+  cl.addOption("-in","-in <models directory>");
+  addRunOptions(cl);
+  cl.addOption("-trace","-trace <trace file of phases and external calls (Chrome trace-event JSON)>",false);
+
+  /* Parse CLI input */
+  auto opt = cl.parse(argc,argv);
+  float mut;
+  if(!configure(*opt, mut)) {
+    cout << "pas de methode choisie" << endl;
+    exit(0);
+  }
   
+  // Spans of timers are traced from the load of models
+  if(opt->at("-trace") != "")
+    Probes::trace(opt->at("-trace"));
+
+  // Input population
+  auto tload = std::chrono::high_resolution_clock::now();
+  auto pop = Population(opt->at("-in"));
+  auto loadTime = std::chrono::duration_cast<std::chrono::milliseconds>
+    (std::chrono::high_resolution_clock::now()-tload).count();
+
+  auto ret = run(*opt, pop, loadTime, mut);
+  Probes::endTrace();
   delete opt;
-  return 0;
+  return ret;
 }
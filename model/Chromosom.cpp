@@ -15,7 +15,7 @@
 #include "Chromosom.h"
 #include <fstream>
 #include <iostream>
-#include <ga/garandom.h>
+#include "utils/Random.h"
 
 /* Static variable initialization */
 
@@ -23,11 +23,12 @@ size_t Chromosom::nbModels = 2;
 
 /* Constructors */
 
-Chromosom::Chromosom(): models(std::vector<Model>()) {}
+Chromosom::Chromosom(): models(std::vector<Model>()), feasible(false) {}
 
-Chromosom::Chromosom(const std::vector<std::string>& files): models(std::vector<Model>()) {
-  for(auto file : files) {
-    models.push_back(file);
+Chromosom::Chromosom(const std::vector<std::string>& files): models(std::vector<Model>()), feasible(false) {
+  models.reserve(files.size());
+  for(auto& file : files) {
+    models.emplace_back(file);
   }
 }
 
@@ -35,8 +36,14 @@ Chromosom::~Chromosom() {}
 
 /* Accessors */
 
-void Chromosom::setModels(std::vector<Model> models) {
+void Chromosom::setModels(const std::vector<Model>& models) {
   this->models = models;
+  feasible = false;
+}
+
+void Chromosom::setModels(std::vector<Model>&& models) {
+  this->models = std::move(models);
+  feasible = false;
 }
 
 std::vector<Model>& Chromosom::getModels() {
@@ -54,29 +61,62 @@ size_t Chromosom::getNbModels() {
 /* Mutate operator */
 
 int Chromosom::mutate(float pmut) {
+  feasible = true;
   if(pmut <= 0.0) return 0;
   int nb = 0;
   for(auto& m : models) {
-    int nbDom = 0;
-    for(auto& val : *(m.getVal())) {
-      if(GARandomFloat(0.0,1.0) <= pmut) {
-	auto dom = m.getDomains()->at(nbDom);
+    auto size = m.getVal()->size();
+    auto& domains = *m.getDomains();
+    // Genes are copied (if shared) only at first mutation
+    Genes* genes = nullptr;
+    std::shared_ptr<const Xcsp> net;
+    for(auto i = 0u; i < size; i++) {
+      if(Random::randomFloat(0.0,1.0) <= pmut) {
+	if(!genes) {
+	  // Values are drawn among consistent ones only if the
+	  // model is a solution of a supported network
+	  net = m.getXcsp();
+	  if(!net->isSupported() || net->size() != size ||
+	     !net->check(*m.getVal())) {
+	    net = nullptr;
+	    feasible = false;
+	  }
+	  genes = &m.editVal();
+	}
+	if(net) {
+	  if(net->mutate(i, *genes)) nb++;
+	  continue;
+	}
+	auto& dom = domains[i];
+	auto& val = (*genes)[i];
 	do {
-	  val = GARandomInt(dom.lbound(),dom.ubound());
+	  val = Random::randomInt(dom.lbound(),dom.ubound());
 	} while(!dom.include(val));
 	nb++;
       }
-      nbDom++;
     }
   }
   return nb;
 }
 
+bool Chromosom::isFeasible() const {
+  return feasible;
+}
+
 bool Chromosom::isValid() const {
   auto valid = true;
-  for(auto m : models) {
+  for(auto& m : models) {
     valid &= m.isValid();
     if(!valid) break;
   }
   return valid;
 }
+
+bool Chromosom::repair() {
+  auto valid = true;
+  for(auto& m : models) {
+    valid &= m.isValid() || m.repair();
+    if(!valid) break;
+  }
+  return valid;
+}
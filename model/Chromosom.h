@@ -41,6 +41,10 @@ class Chromosom {
  protected:
   std::vector<Model> models;
   static size_t nbModels;
+  /**
+   * True if the last mutation kept every model feasible.
+   */
+  bool feasible;
  public:
   int front;
   /**
@@ -75,16 +79,35 @@ class Chromosom {
    * Change actual value of Chromosom
    * \param models The new value of Chromosom
    */
-  virtual void setModels(std::vector<Model> models);
+  virtual void setModels(const std::vector<Model>& models);
+  /**
+   * Change actual value of Chromosom by taking ownership of models.
+   * \param models The new value of Chromosom
+   */
+  virtual void setModels(std::vector<Model>&& models);
   /**
    * Mutate models with a chance of pmut percent.
+   * When the constraint network of a model is supported and the model
+   * is valid, a gene only takes values consistent with the constraints
+   * touching its variable, so the model stays valid.
    * \param pmut The percentage chance of mutation
    * \return The number of mutation
    */
   virtual int mutate(float pmut);
+  /**
+   * Return true if the last mutation is known to have kept the
+   * chromosom valid, in which case isValid need not be called.
+   * \return true iff the chromosom is valid by construction.
+   */
+  bool isFeasible() const;
   /**
    * Return true if the chromosom own only valid models.
    * \return true iff the chromosom is valid.
    */
   virtual bool isValid() const;
+  /**
+   * Try to repair invalid models of the chromosom.
+   * \return true iff the chromosom is valid after repair.
+   */
+  virtual bool repair();
 };
@@ -0,0 +1,96 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file FixedMatrix.h
+ * \brief FixedMatrix class header.
+ * \author Florian Galinier
+ * \version 0.1
+ * \date 19/10/26
+ *
+ * Kernels on score matrices whose size is known at compile time.
+ *
+ */
+
+#pragma once
+#include <cstddef>
+#include "Matrix.h"
+
+/**
+ * \class FixedMatrix
+ * \brief Kernels on the strict upper triangle of a symmetric matrix of
+ * N rows, sized at compile time.
+ *
+ * Elements are stored as in Matrix (strict upper triangle, row by row).
+ * With a constant number of elements, loops of the kernels are unrolled
+ * when optimizing (-O2, the default build). Matrix uses them for
+ * average, min and compare with the usual numbers of models (2, 3 and
+ * 5).
+ *
+ * \author Florian Galinier
+ */
+template <size_t N>
+class FixedMatrix {
+ public:
+  typedef Matrix::Value Value;
+  /**
+   * Number of stored elements.
+   */
+  static constexpr size_t count = N*(N-1)/2;
+  /**
+   * Return the sum of the elements of a triangle.
+   * \param p The triangle.
+   * \return The sum.
+   */
+  static double sum(const Value* p) {
+    double ret = 0;
+    for(size_t k = 0; k < count; k++) {
+      ret += p[k];
+    }
+    return ret;
+  }
+  /**
+   * Return the minimum of a triangle.
+   * \param p The triangle.
+   * \param init The value returned for an empty triangle.
+   * \return The minimum.
+   */
+  static double min(const Value* p, double init) {
+    auto ret = init;
+    for(size_t k = 0; k < count; k++) {
+      ret = (p[k] < ret) ? p[k] : ret;
+    }
+    return ret;
+  }
+  /**
+   * Return the relation (Matrix::Relation bits) of a triangle to
+   * another.
+   * \param a The first triangle.
+   * \param b The second triangle.
+   * \param tolerance Elements differing by less are equal.
+   * \return The relation.
+   */
+  static int relation(const Value* a, const Value* b, Value tolerance) {
+    int ret = 0;
+    for(size_t k = 0; k < count; k++) {
+      auto d = a[k] - b[k];
+      ret |= ((d > tolerance) ? Matrix::GREATER : 0) |
+	((d < -tolerance) ? Matrix::LESS : 0);
+    }
+    return ret;
+  }
+};
+
+template <size_t N>
+constexpr size_t FixedMatrix<N>::count;
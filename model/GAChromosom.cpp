@@ -13,29 +13,32 @@
  */
 
 #include "GAChromosom.h"
-#include <ga/garandom.h>
+#include "utils/Probes.h"
+#include "utils/Random.h"
 #include <limits>
 #include <stdexcept>
 #include <future>
 #include <cstdio>
+#include <algorithm>
+#include <iterator>
 
 /* Constructors */
 
-GAChromosom::GAChromosom(): Chromosom(), GAGenome(GAChromosom::init, GAChromosom::mutate, GAChromosom::compare), sc(3) {
+GAChromosom::GAChromosom(): Chromosom(), GAGenome(GAChromosom::init, GAChromosom::mutate, GAChromosom::compare), scored(false) {
   if(GAChromosom::crossover == GAChromosom::Cross::INTRA)
     GAGenome::crossover(onePointIntraCrossover);
   else GAGenome::crossover(onePointCrossover);
   GAGenome::evaluator(avgEvaluator);
 }
 
-GAChromosom::GAChromosom(const std::vector<std::string>& files): Chromosom(files), GAGenome(GAChromosom::init, GAChromosom::mutate, GAChromosom::compare), sc(3) {
+GAChromosom::GAChromosom(const std::vector<std::string>& files): Chromosom(files), GAGenome(GAChromosom::init, GAChromosom::mutate, GAChromosom::compare), scored(false) {
   if(GAChromosom::crossover == GAChromosom::Cross::INTRA)
     GAGenome::crossover(onePointIntraCrossover);
   else GAGenome::crossover(onePointCrossover);
   GAGenome::evaluator(avgEvaluator);
 }
   
-GAChromosom::GAChromosom(const GAChromosom& c): sc(c.sc) {
+GAChromosom::GAChromosom(const GAChromosom& c): sc(c.sc), scored(c.scored) {
   copy(c);
 }
 
@@ -55,17 +58,23 @@ void GAChromosom::copy(const GAGenome& c) {
 
 /* Accessors */
 
-void GAChromosom::setModels(std::vector<Model> models) {
+void GAChromosom::setModels(const std::vector<Model>& models) {
   Chromosom::setModels(models);
   this->_evaluated = gaFalse;
 }
 
+void GAChromosom::setModels(std::vector<Model>&& models) {
+  Chromosom::setModels(std::move(models));
+  this->_evaluated = gaFalse;
+}
+
 /* Stream methods */
 
 std::string GAChromosom::to_string() const {
   std::string ret;
   for(auto& a : models) {
-    ret += a.to_string()+"\n";
+    a.appendTo(ret);
+    ret += '\n';
   }
   return ret;
 }
@@ -89,53 +98,69 @@ float GAChromosom::compare(const GAGenome& a, const GAGenome& b) {
 void GAChromosom::init(GAGenome&) {}
 
 int GAChromosom::onePointIntraCrossover(const GAGenome& dad, const GAGenome& mom, GAGenome* sis, GAGenome* bro) {
-   GAChromosom& d = (GAChromosom&) dad;
+  GAChromosom& d = (GAChromosom&) dad;
   GAChromosom& m = (GAChromosom&) mom;
-  auto sisModels = std::make_shared<std::vector<Model>>();
-  auto broModels = std::make_shared<std::vector<Model>>();
 
   auto& dadModels = d.getModels();
   auto& momModels = m.getModels();
   auto modelsSize = dadModels[0].getVal()->size();
-  
-  size_t cutPoint =
-    GARandomInt(1,Chromosom::getNbModels()*modelsSize-1);
+
+  // Cut points are chosen where no constraint scope of either parent
+  // is split, so that offspring keep constraints of their parents.
+  std::vector<size_t> cuts;
+  for(auto i = 0u;i<dadModels.size();i++) {
+    if(i) cuts.push_back(i*modelsSize);
+    auto dn = dadModels[i].getXcsp();
+    auto mn = momModels[i].getXcsp();
+    if(dn->size() == modelsSize && mn->size() == modelsSize) {
+      std::vector<size_t> both;
+      std::set_intersection(dn->cutPoints().begin(), dn->cutPoints().end(),
+			    mn->cutPoints().begin(), mn->cutPoints().end(),
+			    std::back_inserter(both));
+      for(auto p : both) cuts.push_back(i*modelsSize + p);
+    }
+    else {
+      for(auto p = 1u; p < modelsSize; p++) cuts.push_back(i*modelsSize + p);
+    }
+  }
+  size_t cutPoint = cuts.empty() ?
+    Random::randomInt(1,Chromosom::getNbModels()*modelsSize-1) :
+    cuts[Random::randomInt(0,cuts.size()-1)];
+
+  std::vector<Model> sisModels, broModels;
+  sisModels.reserve(dadModels.size());
+  broModels.reserve(dadModels.size());
   
   for(auto i = 0u;i<dadModels.size();i++) {
-    std::cout.flush();
-    auto dm = dadModels[i].getVal();
-    auto mm = momModels[i].getVal();
+    auto& dm = *dadModels[i].getVal();
+    auto& mm = *momModels[i].getVal();
+    auto& dd = *dadModels[i].getDomains();
+    auto& md = *momModels[i].getDomains();
+    // Position of the cut inside the current model
+    auto cut = (cutPoint > i*modelsSize) ?
+      std::min(cutPoint - i*modelsSize, modelsSize) : 0;
     auto s = std::make_shared<Genes>();
     auto b = std::make_shared<Genes>();
-    auto dd = dadModels[i].getDomains();
-    auto md = momModels[i].getDomains();
     auto sd = std::make_shared<Domains>();
     auto bd = std::make_shared<Domains>();
-    for(auto j = 0u;j<modelsSize;j++) {
-      if((i*modelsSize + j) < cutPoint) {
-	s->push_back({dm->at(j)});
-	b->push_back({mm->at(j)});
-	sd->push_back({dd->at(j)});
-	bd->push_back({md->at(j)});
-      }
-      else {
-	s->push_back({mm->at(j)});
-	b->push_back({dm->at(j)});
-	sd->push_back({md->at(j)});
-	bd->push_back({dd->at(j)});
-      }
-    }
-    Model sm(momModels[i]), bm(dadModels[i]);
-    sm.setVal(s);
-    bm.setVal(b);
-    sm.setDomains(sd);
-    bm.setDomains(bd);
-    sisModels->push_back(sm);
-    broModels->push_back(bm);
+    s->reserve(modelsSize);
+    b->reserve(modelsSize);
+    sd->reserve(modelsSize);
+    bd->reserve(modelsSize);
+    s->insert(s->end(), dm.begin(), dm.begin()+cut);
+    s->insert(s->end(), mm.begin()+cut, mm.end());
+    b->insert(b->end(), mm.begin(), mm.begin()+cut);
+    b->insert(b->end(), dm.begin()+cut, dm.end());
+    sd->insert(sd->end(), dd.begin(), dd.begin()+cut);
+    sd->insert(sd->end(), md.begin()+cut, md.end());
+    bd->insert(bd->end(), md.begin(), md.begin()+cut);
+    bd->insert(bd->end(), dd.begin()+cut, dd.end());
+    sisModels.emplace_back(momModels[i], std::move(s), std::move(sd));
+    broModels.emplace_back(dadModels[i], std::move(b), std::move(bd));
   }
   
-  dynamic_cast<GAChromosom*>(sis)->setModels(*sisModels);
-  dynamic_cast<GAChromosom*>(bro)->setModels(*broModels);
+  dynamic_cast<GAChromosom*>(sis)->setModels(std::move(sisModels));
+  dynamic_cast<GAChromosom*>(bro)->setModels(std::move(broModels));
   
   return 2;
 }
@@ -143,92 +168,99 @@ int GAChromosom::onePointIntraCrossover(const GAGenome& dad, const GAGenome& mom
 int GAChromosom::onePointCrossover(const GAGenome& dad, const GAGenome& mom, GAGenome* sis, GAGenome* bro) {
   GAChromosom& d = (GAChromosom&) dad;
   GAChromosom& m = (GAChromosom&) mom;
-  auto sisModels = std::make_shared<std::vector<Model>>();
-  auto broModels = std::make_shared<std::vector<Model>>();
 
-  size_t cutPoint = GARandomInt(1,Chromosom::getNbModels()-1);
+  size_t cutPoint = Random::randomInt(1,Chromosom::getNbModels()-1);
 
   auto& dadModels = d.getModels();
   auto& momModels = m.getModels();
 
+  // Offspring models are built in place and then moved into children
+  std::vector<Model> sisModels, broModels;
+  sisModels.reserve(dadModels.size());
+  broModels.reserve(dadModels.size());
+
   for(auto i = 0u;i<dadModels.size();i++) {
     if(i < cutPoint) {
-       sisModels->push_back(Model(dadModels[i]));
-       broModels->push_back(Model(momModels[i]));
+      sisModels.emplace_back(dadModels[i]);
+      broModels.emplace_back(momModels[i]);
     }
     else {
-      sisModels->push_back(Model(momModels[i]));
-      broModels->push_back(Model(dadModels[i]));
+      sisModels.emplace_back(momModels[i]);
+      broModels.emplace_back(dadModels[i]);
     }
   }
   
-  dynamic_cast<GAChromosom*>(sis)->setModels(*sisModels);
-  dynamic_cast<GAChromosom*>(bro)->setModels(*broModels);
+  dynamic_cast<GAChromosom*>(sis)->setModels(std::move(sisModels));
+  dynamic_cast<GAChromosom*>(bro)->setModels(std::move(broModels));
   
   return 2;
 }
 
-std::vector<MatrixPtr> GAChromosom::evaluate(GABoolean flag) {
-  auto sco = this->score();
-  if(flag || (!sco[0] && !sco[1] && !sco[2])) {
-    auto ev = GAChromosom::evaluate(*this);
+const Objectives& GAChromosom::evaluate(GABoolean flag) {
+  if(flag || !scored) {
+    GAChromosom::evaluate(*this, sc);
     // this->_evaluated = gaTrue;
-    return this->score(ev);
+    return this->score(sc);
   }
   else
-    return sco;
+    return sc;
 }
 
-std::vector<MatrixPtr> GAChromosom::score(std::vector<MatrixPtr> m) {
-  GAGenome::score((method & Method::COSINE)?m[0]->average():0 +
-		  (method & Method::HAMMING)?m[1]->average():0 +
-		  (method & Method::CENTRALITY)?m[2]->average():0 +
-		  (method & Method::LEVENSHTEIN)?m[3]->average():0 +
-		  (method & Method::LEVEXTERN)?m[4]->average():0);
-  sc = m;
+const Objectives& GAChromosom::score(const Objectives& o) {
+  GAGenome::score((method & Method::COSINE)?o.average(Objectives::COSINE):0 +
+		  (method & Method::HAMMING)?o.average(Objectives::HAMMING):0 +
+		  (method & Method::CENTRALITY)?o.average(Objectives::CENTRALITY):0 +
+		  (method & Method::LEVENSHTEIN)?o.average(Objectives::LEVENSHTEIN):0 +
+		  (method & Method::LEVEXTERN)?o.average(Objectives::LEVEXTERN):0);
+  if(&o != &sc)
+    sc = o;
+  scored = true;
   return sc;
 }
 
-std::vector<MatrixPtr> GAChromosom::score() const {
+const Objectives& GAChromosom::score() const {
   return sc;
 }
 
-std::vector<MatrixPtr> GAChromosom::evaluate(GAGenome& g) {
+bool GAChromosom::isScored() const {
+  return scored;
+}
+
+void GAChromosom::evaluate(GAGenome& g, Objectives& res) {
+  PROBE_TIMER("chromosom evaluation");
   GAChromosom& c = (GAChromosom&) g;
-  MatrixPtr levenshtein = std::make_shared<Matrix>(nbModels),
-    cosine = std::make_shared<Matrix>(nbModels),
-    hamming = std::make_shared<Matrix>(nbModels),
-    centrality = std::make_shared<Matrix>(nbModels),
-    levextern = std::make_shared<Matrix>(nbModels);
-  auto minDist = c.score();
+  res.reset(nbModels);
   auto i = 0u;
   for(auto m1 = std::begin(c.models), end = std::end(c.models);m1 < end; m1++) {
     auto j = i + 1;
     for(auto m2 = m1 + 1; m2 < end; m2++) {
       if(*m1 != *m2) {
 				if(GAChromosom::method & GAChromosom::Method::LEVENSHTEIN){
-					levenshtein->set(i,j,Model::levenshteinDistance(*m1,*m2));
+					PROBE_TIMER("levenshtein");
+					res.set(Objectives::LEVENSHTEIN,i,j,Model::levenshteinDistance(*m1,*m2));
 				}
 				if(GAChromosom::method & GAChromosom::Method::COSINE){
-					cosine->set(i,j,Model::cosineDistance(*m1,*m2));
+					res.set(Objectives::COSINE,i,j,Model::cosineDistance(*m1,*m2));
 				}
 				if((GAChromosom::method & GAChromosom::Method::HAMMING) ||(GAChromosom::method & GAChromosom::Method::CENTRALITY) ||(GAChromosom::method & GAChromosom::Method::LEVEXTERN)) {
-					auto res = Model::evaluateExtern(*m1,*m2);
-					hamming->set(i,j,std::get<0>(res));
-					centrality->set(i,j,std::get<1>(res));
-					levextern->set(i,j,std::get<2>(res));
+					auto d = Model::evaluateExtern(*m1,*m2);
+					res.set(Objectives::HAMMING,i,j,std::get<0>(d));
+					res.set(Objectives::CENTRALITY,i,j,std::get<1>(d));
+					res.set(Objectives::LEVEXTERN,i,j,std::get<2>(d));
 				}
 				j++;
       }
     }
     i++;
   }
-  return {cosine,hamming,centrality,levenshtein,levextern};
 }
 
 float GAChromosom::avgEvaluator(GAGenome& g) {
-  auto res = evaluate(g);
-  return (res[0]->average() + res[1]->average() + res[2]->average() + res[3]->average() + res[4]->average()) /
+  Objectives res;
+  evaluate(g, res);
+  return (res.average(Objectives::COSINE) + res.average(Objectives::HAMMING) +
+	  res.average(Objectives::CENTRALITY) + res.average(Objectives::LEVENSHTEIN) +
+	  res.average(Objectives::LEVEXTERN)) /
     ((GAChromosom::method & GAChromosom::Method::COSINE && 1) +
      (GAChromosom::method & GAChromosom::Method::HAMMING && 1) +
      (GAChromosom::method & GAChromosom::Method::CENTRALITY && 1) +
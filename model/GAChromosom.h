@@ -29,6 +29,7 @@
 #include <functional>
 #include "utils/Logger.h"
 #include "Matrix.h"
+#include "Objectives.h"
 
 /**
  * Smart pointer to a Matrix.
@@ -45,7 +46,8 @@ typedef std::shared_ptr<Matrix> MatrixPtr;
  */
 class GAChromosom : public Chromosom, public GAGenome {
  private:
-  std::vector<MatrixPtr> sc;
+  Objectives sc;
+  bool scored;
  public:
   enum Method {
     COSINE      = 0b00001,
@@ -77,17 +79,21 @@ class GAChromosom : public Chromosom, public GAGenome {
    */
   virtual ~GAChromosom() noexcept;
   /**
-   * Set the matrix score.
-   * \param m The new matrix score.
-   * \return The new matrix score.
+   * Set the objectives.
+   * \param o The new objectives.
+   * \return The new objectives.
    */
-  virtual std::vector<MatrixPtr> score(std::vector<MatrixPtr> m);
+  virtual const Objectives& score(const Objectives& o);
   /**
-   * Return the matrix score (if matrix is null, score is
-   * not yet set).
-   * \return The matrix score.
+   * Return the objectives (null until the chromosom is scored).
+   * \return The objectives.
    */
-  virtual std::vector<MatrixPtr> score() const;
+  virtual const Objectives& score() const;
+  /**
+   * Return true if objectives are set.
+   * \return true iff the chromosom is scored.
+   */
+  bool isScored() const;
   /**
    * Return a new GAGenome that is a copy of actual one.
    * \param method Clone method to use for copy (optional)
@@ -104,7 +110,12 @@ class GAChromosom : public Chromosom, public GAGenome {
    * Change actual value of GAChromosom
    * \param models The new value of GAChromosom
    */
-  virtual void setModels(std::vector<Model> models);
+  virtual void setModels(const std::vector<Model>& models);
+  /**
+   * Change actual value of GAChromosom by taking ownership of models.
+   * \param models The new value of GAChromosom
+   */
+  virtual void setModels(std::vector<Model>&& models);
   /**
    * Convert chromosom to a string representation.
    * \return A string representation of current chromosom.
@@ -149,11 +160,12 @@ class GAChromosom : public Chromosom, public GAGenome {
    */
   static int onePointCrossover(const GAGenome& dad, const GAGenome& mom, GAGenome* sis, GAGenome* bro);
   /**
-   * Give a fitness value of the actual GAChromosom
+   * Give a fitness value of the actual GAChromosom. Objectives are
+   * computed in place.
    * \param gaFlag Force or not the evaluation
-   * \return The fitness value of the GAChromosom
+   * \return The objectives of the GAChromosom
    */
-  virtual std::vector<MatrixPtr> evaluate(GABoolean gaFlag = gaFalse);
+  virtual const Objectives& evaluate(GABoolean gaFlag = gaFalse);
   /**
    * Give an average fitness value for 
    * the given GAChromosom (greater is better)
@@ -162,12 +174,12 @@ class GAChromosom : public Chromosom, public GAGenome {
    */
   static float avgEvaluator(GAGenome& g);
   /**
-   * Give a matrix of distance value for
+   * Compute distances between models of
    * the given GAChromosom (greater is better)
    * \param g The GAChromosom to evaluate
-   * \return The fitness value of the GAChromosom
+   * \param res The objectives where to write distances
    */
-  static std::vector<MatrixPtr> evaluate(GAGenome& g);
+  static void evaluate(GAGenome& g, Objectives& res);
   /**
    * Mutate the given GAChromosom.
    * \param g The GAChromosom to mutate
@@ -0,0 +1,443 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GenFile.h"
+#include "Population.h"
+#include "GAChromosom.h"
+#include "Matrix.h"
+#include "utils/Format.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+  const char magic[8] = {'M','D','E','A','G','E','N','\0'};
+  const uint32_t version = 2;
+
+  template <typename T>
+  void append(std::vector<char>& buf, const T* v, size_t n) {
+    auto pos = buf.size();
+    buf.resize(pos + n*sizeof(T));
+    if(n) std::memcpy(buf.data()+pos, v, n*sizeof(T));
+  }
+
+  /* Hash of the genes of an individual */
+  size_t hash(const std::vector<ConstGenesPtr>& models) {
+    size_t h = models.size();
+    for(auto& m : models) {
+      for(auto g : *m) {
+	h ^= std::hash<int>()(g) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+      }
+      h = h*31 + m->size();
+    }
+    return h;
+  }
+
+  bool sameGenes(const std::vector<ConstGenesPtr>& m1,
+		 const std::vector<ConstGenesPtr>& m2) {
+    if(m1.size() != m2.size()) return false;
+    for(auto k = 0u; k < m1.size(); k++) {
+      if(m1[k] != m2[k] && *m1[k] != *m2[k]) return false;
+    }
+    return true;
+  }
+}
+
+/* Snapshot of the last written generation */
+
+struct GenFile::Snapshot {
+  unsigned int generation;
+  size_t models;
+  size_t objectives;
+  size_t popScoreSize;
+  /* Genes and scores (objectives×n×n) of each individual */
+  std::vector<std::vector<ConstGenesPtr>> genes;
+  std::vector<std::vector<double>> scores;
+  std::vector<double> popScores;
+  /* Individuals by hash of their genes */
+  std::unordered_multimap<size_t,size_t> index;
+};
+
+/* Constructors */
+
+GenFile::GenFile(const std::string& path): data(nullptr), length(0) {
+  auto fd = open(path.c_str(), O_RDONLY);
+  if(fd < 0)
+    throw std::runtime_error("Could not open generation file "+path+".");
+  struct stat st;
+  if(fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+    close(fd);
+    throw std::runtime_error(path+" is not a generation file.");
+  }
+  length = st.st_size;
+  auto addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(addr == MAP_FAILED)
+    throw std::runtime_error("Could not map generation file "+path+".");
+  data = static_cast<const char*>(addr);
+  header = reinterpret_cast<const Header*>(data);
+
+  // Check that every block lies in the file
+  auto p = static_cast<uint64_t>(header->individuals);
+  auto n = static_cast<uint64_t>(header->models);
+  auto s = static_cast<uint64_t>(header->popScoreSize);
+  auto inside = [this](uint64_t offset, uint64_t size) {
+    return offset <= length && size <= length - offset;
+  };
+  auto delta = header->kind == DELTA;
+  // Keyframes store every individual, deltas the genes of new ones and
+  // the scores of new and changed ones
+  auto stored = p, scored = p;
+  auto valid = !std::memcmp(header->magic, magic, sizeof(magic)) &&
+    header->version == version &&
+    (header->kind == KEYFRAME || delta) &&
+    inside(header->entryOffset, (delta ? p : 0)*sizeof(Entry));
+  if(valid && delta) {
+    auto entries = reinterpret_cast<const Entry*>(data+header->entryOffset);
+    stored = scored = 0;
+    for(auto i = 0u; i < p; i++) {
+      stored += entries[i].ref < 0;
+      scored += entries[i].ref < 0 || entries[i].changed;
+    }
+  }
+  valid = valid &&
+    inside(header->popScoreOffset, delta ? header->popScoreCount*sizeof(PopScore)
+	   : s*s*sizeof(double)) &&
+    inside(header->scoreOffset, scored*header->objectives*n*n*sizeof(double)) &&
+    inside(header->geneIndexOffset, (stored*n+1)*sizeof(uint64_t));
+  if(valid) {
+    popScores = reinterpret_cast<const double*>(data+header->popScoreOffset);
+    scores = reinterpret_cast<const double*>(data+header->scoreOffset);
+    geneIndex = reinterpret_cast<const uint64_t*>(data+header->geneIndexOffset);
+    genes = reinterpret_cast<const int32_t*>(data+header->geneOffset);
+    valid = inside(header->geneOffset, geneIndex[stored*n]*sizeof(int32_t));
+  }
+  if(!valid) {
+    munmap(const_cast<char*>(data), length);
+    throw std::runtime_error(path+" is not a generation file.");
+  }
+  if(delta) {
+    try {
+      reconstruct(path);
+    } catch(...) {
+      munmap(const_cast<char*>(data), length);
+      throw;
+    }
+  }
+}
+
+GenFile::~GenFile() {
+  if(data) munmap(const_cast<char*>(data), length);
+}
+
+void GenFile::reconstruct(const std::string& path) {
+  if(header->base >= header->generation)
+    throw std::runtime_error(path+" is not a generation file.");
+  GenFile base(pathOf(path, header->base));
+  size_t p = size(), n = nbModels(), o = nbObjectives(), s = header->popScoreSize;
+  if(base.nbModels() != n || base.nbObjectives() != o)
+    throw std::runtime_error(path+" does not match its base generation.");
+  auto entries = reinterpret_cast<const Entry*>(data+header->entryOffset);
+  auto stride = o*n*n;
+  scoresData.reserve(p*stride);
+  geneIndexData.reserve(p*n+1);
+  geneIndexData.push_back(0);
+  auto nextScores = scores;
+  auto nextNew = 0u;
+  for(auto i = 0u; i < p; i++) {
+    auto ref = entries[i].ref;
+    if(ref >= 0 && static_cast<size_t>(ref) >= base.size())
+      throw std::runtime_error(path+" does not match its base generation.");
+    if(ref < 0 || entries[i].changed) {
+      scoresData.insert(scoresData.end(), nextScores, nextScores+stride);
+      nextScores += stride;
+    }
+    else {
+      scoresData.insert(scoresData.end(), base.scores+ref*stride,
+			base.scores+(ref+1)*stride);
+    }
+    for(auto k = 0u; k < n; k++) {
+      auto g = (ref < 0) ? Genes{genes+geneIndex[nextNew*n+k],
+				 static_cast<size_t>(geneIndex[nextNew*n+k+1]-geneIndex[nextNew*n+k])}
+	: base.getGenes(ref, k);
+      genesData.insert(genesData.end(), g.begin(), g.end());
+      geneIndexData.push_back(genesData.size());
+    }
+    nextNew += ref < 0;
+  }
+  // Population scores of surviving pairs come from base
+  popScoresData.assign(s*s, 0.0);
+  if(base.header->popScoreSize) {
+    for(auto i = 0u; i < s && i < p; i++) {
+      if(entries[i].ref < 0) continue;
+      for(auto j = 0u; j < s && j < p; j++) {
+	if(entries[j].ref < 0) continue;
+	popScoresData[i*s+j] = base.popScore(entries[i].ref, entries[j].ref);
+      }
+    }
+  }
+  auto changes = reinterpret_cast<const PopScore*>(popScores);
+  for(auto c = 0u; c < header->popScoreCount; c++) {
+    if(changes[c].i >= s || changes[c].j >= s)
+      throw std::runtime_error(path+" is not a generation file.");
+    popScoresData[changes[c].i*s+changes[c].j] = changes[c].value;
+  }
+  popScores = popScoresData.data();
+  scores = scoresData.data();
+  geneIndex = geneIndexData.data();
+  genes = genesData.data();
+}
+
+std::string GenFile::pathOf(const std::string& path, unsigned int gen) {
+  auto end = path.find_last_not_of("0123456789");
+  return path.substr(0, end+1)+std::to_string(gen);
+}
+
+/* Writer */
+
+GenFile::Writer::Writer(unsigned int keyframe):
+  keyframe(keyframe ? keyframe : 1), sinceKeyframe(0) {}
+
+size_t GenFile::Writer::write(const std::string& path, unsigned int gen,
+			      const Population& pop, const Matrix* popScores) {
+  auto snap = std::make_shared<Snapshot>();
+  size_t p = pop.size();
+  size_t n = p ? static_cast<GAChromosom&>(pop.individual(0)).getModels().size() : 0;
+  size_t objectives = p ? Objectives::KINDS : 0;
+  size_t s = popScores ? popScores->size() : 0;
+  snap->generation = gen;
+  snap->models = n;
+  snap->objectives = objectives;
+  snap->popScoreSize = s;
+  snap->genes.resize(p);
+  snap->scores.resize(p);
+  for(auto i = 0u; i < p; i++) {
+    auto& ind = static_cast<GAChromosom&>(pop.individual(i));
+    if(ind.getModels().size() != n)
+      throw std::logic_error("Individuals of a generation must have the same number of models.");
+    for(auto& m : ind.getModels()) {
+      snap->genes[i].push_back(m.getVal());
+    }
+    auto& sc = snap->scores[i];
+    sc.assign(objectives*n*n, 0.0);
+    auto& res = ind.score();
+    if(ind.isScored() && res.size() == n) {
+      for(auto k = 0u; k < objectives; k++) {
+	for(auto r = 0u; r < n; r++) {
+	  for(auto c = 0u; c < n; c++) {
+	    sc[(k*n+r)*n+c] = res.get(static_cast<Objectives::Kind>(k),r,c);
+	  }
+	}
+      }
+    }
+    snap->index.emplace(hash(snap->genes[i]), i);
+  }
+  snap->popScores.resize(s*s);
+  for(auto i = 0u; i < s; i++) {
+    for(auto j = 0u; j < s; j++) {
+      snap->popScores[i*s+j] = popScores->get(i,j);
+    }
+  }
+
+  // A delta needs a base of the same shape
+  auto delta = previous && ++sinceKeyframe < keyframe &&
+    previous->models == n && previous->objectives == objectives &&
+    !previous->popScoreSize == !s;
+  if(!delta) sinceKeyframe = 0;
+
+  std::vector<Entry> entries(delta ? p : 0);
+  for(auto i = 0u; i < entries.size(); i++) {
+    entries[i] = {-1, 0};
+    auto range = previous->index.equal_range(hash(snap->genes[i]));
+    for(auto it = range.first; it != range.second; ++it) {
+      if(sameGenes(previous->genes[it->second], snap->genes[i])) {
+	entries[i].ref = it->second;
+	entries[i].changed = previous->scores[it->second] != snap->scores[i];
+	break;
+      }
+    }
+  }
+  std::vector<PopScore> changes;
+  if(delta) {
+    for(auto i = 0u; i < s; i++) {
+      for(auto j = 0u; j < s; j++) {
+	auto v = snap->popScores[i*s+j];
+	auto ri = i < p ? entries[i].ref : -1;
+	auto rj = j < p ? entries[j].ref : -1;
+	auto ps = previous->popScoreSize;
+	auto old = (ri >= 0 && rj >= 0 && static_cast<size_t>(ri) < ps
+		    && static_cast<size_t>(rj) < ps)
+	  ? previous->popScores[ri*ps+rj] : 0.0;
+	if(v != old) changes.push_back({i, j, v});
+      }
+    }
+  }
+  auto isNew = [&entries](size_t i) {
+    return entries.empty() || entries[i].ref < 0;
+  };
+  auto isScored = [&entries](size_t i) {
+    return entries.empty() || entries[i].ref < 0 || entries[i].changed;
+  };
+
+  size_t stored = 0, scored = 0;
+  for(auto i = 0u; i < p; i++) {
+    stored += isNew(i);
+    scored += isScored(i);
+  }
+  Header h;
+  std::memset(&h, 0, sizeof(h));
+  std::memcpy(h.magic, magic, sizeof(magic));
+  h.version = version;
+  h.generation = gen;
+  h.individuals = p;
+  h.models = n;
+  h.objectives = objectives;
+  h.popScoreSize = s;
+  h.kind = delta ? DELTA : KEYFRAME;
+  h.base = delta ? previous->generation : gen;
+  h.popScoreOffset = sizeof(Header);
+  h.popScoreCount = delta ? changes.size() : s*s;
+  h.scoreOffset = h.popScoreOffset +
+    (delta ? changes.size()*sizeof(PopScore) : s*s*sizeof(double));
+  h.entryOffset = h.scoreOffset + scored*objectives*n*n*sizeof(double);
+  h.geneIndexOffset = h.entryOffset + entries.size()*sizeof(Entry);
+  h.geneOffset = h.geneIndexOffset + (stored*n+1)*sizeof(uint64_t);
+
+  std::vector<char> buf;
+  buf.reserve(h.geneOffset);
+  append(buf, &h, 1);
+  if(delta) append(buf, changes.data(), changes.size());
+  else append(buf, snap->popScores.data(), snap->popScores.size());
+  for(auto i = 0u; i < p; i++) {
+    if(isScored(i)) append(buf, snap->scores[i].data(), snap->scores[i].size());
+  }
+  append(buf, entries.data(), entries.size());
+  std::vector<uint64_t> index;
+  index.reserve(stored*n+1);
+  index.push_back(0);
+  for(auto i = 0u; i < p; i++) {
+    if(!isNew(i)) continue;
+    for(auto& g : snap->genes[i]) {
+      index.push_back(index.back() + g->size());
+    }
+  }
+  append(buf, index.data(), index.size());
+  static_assert(sizeof(int) == sizeof(int32_t), "genes are stored as int32");
+  for(auto i = 0u; i < p; i++) {
+    if(!isNew(i)) continue;
+    for(auto& g : snap->genes[i]) {
+      append(buf, g->data(), g->size());
+    }
+  }
+
+  std::ofstream out(path, std::ios_base::out | std::ios_base::binary);
+  out.write(buf.data(), buf.size());
+  previous = std::move(snap);
+  return buf.size();
+}
+
+void GenFile::write(const std::string& path, unsigned int gen,
+		    const Population& pop, const Matrix* popScores) {
+  Writer().write(path, gen, pop, popScores);
+}
+
+/* Accessors */
+
+unsigned int GenFile::generation() const {
+  return header->generation;
+}
+
+bool GenFile::isKeyframe() const {
+  return header->kind == KEYFRAME;
+}
+
+size_t GenFile::size() const {
+  return header->individuals;
+}
+
+size_t GenFile::nbModels() const {
+  return header->models;
+}
+
+size_t GenFile::nbObjectives() const {
+  return header->objectives;
+}
+
+bool GenFile::hasPopScores() const {
+  return header->popScoreSize != 0;
+}
+
+GenFile::Genes GenFile::getGenes(size_t ind, size_t model) const {
+  if(ind >= size() || model >= nbModels())
+    throw std::out_of_range("Try to access to unknown model "+std::to_string(model)+" of individual "+std::to_string(ind)+".");
+  auto k = ind*nbModels()+model;
+  return {genes+geneIndex[k], static_cast<size_t>(geneIndex[k+1]-geneIndex[k])};
+}
+
+double GenFile::score(size_t ind, size_t obj, size_t i, size_t j) const {
+  auto n = nbModels();
+  if(ind >= size() || obj >= nbObjectives() || i >= n || j >= n)
+    throw std::out_of_range("Try to access to unknown score of individual "+std::to_string(ind)+".");
+  return scores[((ind*nbObjectives()+obj)*n+i)*n+j];
+}
+
+double GenFile::popScore(size_t i, size_t j) const {
+  auto s = header->popScoreSize;
+  if(i >= s || j >= s)
+    throw std::out_of_range("Try to access to unknown population score.");
+  return popScores[i*s+j];
+}
+
+/* Stream methods */
+
+std::string GenFile::to_string() const {
+  std::string ret;
+  auto matrix = [&ret](const double* m, size_t n) {
+    for(auto i = 0u; i < n; i++) {
+      ret += "[ ";
+      for(auto j = 0u; j < n; j++) {
+	Format::appendFixed(ret, m[i*n+j]);
+	ret += ' ';
+      }
+      ret += "]\n";
+    }
+  };
+  // Roughly 10 characters per score and 4 per gene
+  auto n = nbModels();
+  auto s = header->popScoreSize;
+  ret.reserve(10*(s*s+size()*nbObjectives()*n*n)+4*geneIndex[size()*n]);
+  matrix(popScores, s);
+  for(auto i = 0u; i < size(); i++) {
+    ret += "--------------\n";
+    for(auto k = 0u; k < n; k++) {
+      for(auto g : getGenes(i, k)) {
+	Format::appendInteger(ret, g);
+	ret += ' ';
+      }
+      ret += '\n';
+    }
+    ret += '\n';
+    for(auto o = 0u; o < nbObjectives(); o++) {
+      matrix(scores+(i*nbObjectives()+o)*n*n, n);
+      ret += '\n';
+    }
+  }
+  return ret;
+}
@@ -0,0 +1,260 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file GenFile.h
+ * \brief GenFile class header.
+ * \author Florian Galinier
+ * \version 0.1
+ * \date 19/10/26
+ *
+ * Binary generation output (output/genN).
+ *
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory>
+
+class Population;
+class Matrix;
+
+/**
+ * \class GenFile
+ * \brief A generation file, mapped in memory.
+ *
+ * A generation file stores the population of a generation in native
+ * byte order:
+ * - a fixed size header (see GenFile::Header);
+ * - the population score matrix (nb = 1 only), P×P doubles;
+ * - the score block, for each individual and objective a n×n matrix
+ *   of doubles (n being the number of models per individual);
+ * - the entry block (deltas only, see below);
+ * - the gene index, P×n+1 offsets (uint64) of models in gene block;
+ * - the gene block, genes of every model as int32, individual by
+ *   individual.
+ *
+ * Blocks are ordered by decreasing alignment so that every block can be
+ * read in place.
+ *
+ * A file is either a keyframe, holding the whole population, or a delta
+ * against the file of generation base (same path, generation number
+ * replaced). A delta holds one entry per individual, giving the index of
+ * the same individual in base (-1 for a new one) and whether its scores
+ * changed. Scores are stored for new and changed individuals only, genes
+ * for new individuals only, and the population score matrix as a list
+ * of (i,j,value) for elements that differ from base. Opening a delta
+ * reconstructs the generation in memory.
+ *
+ * \author Florian Galinier
+ */
+class GenFile {
+ public:
+  /**
+   * \brief Kind of generation file.
+   */
+  enum Kind {
+    KEYFRAME = 0,
+    DELTA = 1,
+  };
+  /**
+   * \brief Header of a generation file.
+   */
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t generation;
+    uint32_t individuals;
+    uint32_t models;
+    uint32_t objectives;
+    uint32_t popScoreSize;
+    uint32_t kind;
+    uint32_t base;
+    uint64_t popScoreOffset;
+    uint64_t popScoreCount;
+    uint64_t scoreOffset;
+    uint64_t entryOffset;
+    uint64_t geneIndexOffset;
+    uint64_t geneOffset;
+  };
+  /**
+   * \brief Entry of an individual in a delta.
+   */
+  struct Entry {
+    int32_t ref;
+    uint32_t changed;
+  };
+  /**
+   * \brief Changed element of the population score matrix in a delta.
+   */
+  struct PopScore {
+    uint32_t i;
+    uint32_t j;
+    double value;
+  };
+  /**
+   * \brief Genes of a model, read in place.
+   */
+  struct Genes {
+    const int32_t* data;
+    size_t length;
+    const int32_t* begin() const { return data; }
+    const int32_t* end() const { return data+length; }
+    size_t size() const { return length; }
+    int32_t operator[](size_t i) const { return data[i]; }
+  };
+  /**
+   * \brief Content of a generation kept in memory by a Writer.
+   */
+  struct Snapshot;
+  /**
+   * \class GenFile::Writer
+   * \brief Writer of the generation files of a run.
+   *
+   * Every keyframe-th file is a keyframe, others are deltas against the
+   * file written before.
+   */
+  class Writer {
+   private:
+    unsigned int keyframe;
+    unsigned int sinceKeyframe;
+    std::shared_ptr<const Snapshot> previous;
+   public:
+    /**
+     * Create a writer.
+     * \param keyframe The keyframe interval (1: keyframes only).
+     */
+    Writer(unsigned int keyframe = 1);
+    /**
+     * Write the generation file of a population.
+     * \param path The file path (ending with the generation number).
+     * \param gen The generation number.
+     * \param pop The evaluated population.
+     * \param popScores The population score matrix (nb = 1), or nullptr.
+     * \return The number of bytes written.
+     */
+    size_t write(const std::string& path, unsigned int gen,
+		 const Population& pop, const Matrix* popScores = nullptr);
+  };
+ private:
+  const char* data;
+  size_t length;
+  const Header* header;
+  const double* popScores;
+  const double* scores;
+  const uint64_t* geneIndex;
+  const int32_t* genes;
+  /* Reconstructed blocks of a delta */
+  std::vector<double> popScoresData;
+  std::vector<double> scoresData;
+  std::vector<uint64_t> geneIndexData;
+  std::vector<int32_t> genesData;
+  /**
+   * Reconstruct a delta from its base file.
+   * \param path The path of the delta.
+   */
+  void reconstruct(const std::string& path);
+ public:
+  /**
+   * Map a generation file.
+   * \param path The file path.
+   * \throw std::runtime_error if the file (or the base of a delta) can
+   * not be read or is not a generation file.
+   */
+  GenFile(const std::string& path);
+  GenFile(const GenFile&) = delete;
+  GenFile& operator=(const GenFile&) = delete;
+  /**
+   * Unmap the file.
+   */
+  virtual ~GenFile() noexcept;
+  /**
+   * Write the keyframe generation file of a population.
+   * \param path The file path.
+   * \param gen The generation number.
+   * \param pop The evaluated population.
+   * \param popScores The population score matrix (nb = 1), or nullptr.
+   */
+  static void write(const std::string& path, unsigned int gen,
+		    const Population& pop, const Matrix* popScores = nullptr);
+  /**
+   * Return the path of the file of another generation.
+   * \param path The path of a generation file (ending with its number).
+   * \param gen The other generation number.
+   * \return The path of the other generation file.
+   */
+  static std::string pathOf(const std::string& path, unsigned int gen);
+  /**
+   * Return the generation number.
+   * \return The generation number.
+   */
+  unsigned int generation() const;
+  /**
+   * Return true if the file is a keyframe.
+   * \return true iff the file is a keyframe.
+   */
+  bool isKeyframe() const;
+  /**
+   * Return the number of individuals.
+   * \return The number of individuals.
+   */
+  size_t size() const;
+  /**
+   * Return the number of models of an individual.
+   * \return The number of models.
+   */
+  size_t nbModels() const;
+  /**
+   * Return the number of objectives (score matrices) of an individual.
+   * \return The number of objectives.
+   */
+  size_t nbObjectives() const;
+  /**
+   * Return true if the file contains the population score matrix.
+   * \return true iff the population score matrix is available.
+   */
+  bool hasPopScores() const;
+  /**
+   * Return genes of a model.
+   * \param ind The individual.
+   * \param model The model of individual.
+   * \return The genes, valid while the file is mapped.
+   */
+  Genes getGenes(size_t ind, size_t model) const;
+  /**
+   * Return an element of a score matrix of an individual.
+   * \param ind The individual.
+   * \param obj The objective.
+   * \param i The row.
+   * \param j The column.
+   * \return The score.
+   */
+  double score(size_t ind, size_t obj, size_t i, size_t j) const;
+  /**
+   * Return an element of the population score matrix.
+   * \param i The row.
+   * \param j The column.
+   * \return The score.
+   */
+  double popScore(size_t i, size_t j) const;
+  /**
+   * Return the text view of the generation (format of former text
+   * generation files).
+   * \return The text view.
+   */
+  std::string to_string() const;
+};
@@ -0,0 +1,210 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Indicators.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+  typedef Indicators::Point Point;
+
+  /* Volume of the box from the origin to a point */
+  double box(const Point& p) {
+    auto v = 1.0;
+    for(auto x : p) {
+      v *= x;
+    }
+    return v;
+  }
+
+  /* Hypervolume of non-dominated points with non negative coordinates
+     (WFG: sum of the exclusive contributions of points, the one of a
+     point being its box minus the hypervolume of the others limited to
+     its box) */
+  double wfg(std::vector<Point>& s) {
+    if(s.empty()) return 0;
+    auto d = s[0].size();
+    if(d == 1) return s[0][0];
+    if(d == 2) {
+      // Decreasing first coordinate, so increasing second one
+      std::sort(s.begin(), s.end(), [](const Point& p, const Point& q) {
+	  return p[0] > q[0];
+	});
+      auto v = 0.0, y = 0.0;
+      for(auto& p : s) {
+	v += p[0]*(p[1]-y);
+	y = p[1];
+      }
+      return v;
+    }
+    // Decreasing last coordinate: limited sets of the first points,
+    // the largest, are the smallest
+    std::sort(s.begin(), s.end(), [d](const Point& p, const Point& q) {
+	return p[d-1] > q[d-1];
+      });
+    auto v = 0.0;
+    for(auto i = 0u; i < s.size(); i++) {
+      std::vector<Point> limited;
+      limited.reserve(s.size()-i-1);
+      for(auto j = i+1; j < s.size(); j++) {
+	Point q(d);
+	for(auto k = 0u; k < d; k++) {
+	  q[k] = std::min(s[i][k], s[j][k]);
+	}
+	limited.push_back(std::move(q));
+      }
+      auto f = Indicators::front(limited);
+      v += box(s[i])-wfg(f);
+    }
+    return v;
+  }
+}
+
+/* Constructors */
+
+Indicators::Indicators(): volume(0), distance(0), frontSize(0) {}
+
+/* Indicators */
+
+bool Indicators::dominates(const Point& p, const Point& q) {
+  auto greater = false;
+  for(auto k = 0u; k < p.size(); k++) {
+    if(p[k] < q[k]) return false;
+    if(p[k] > q[k]) greater = true;
+  }
+  return greater;
+}
+
+std::vector<Indicators::Point> Indicators::front(const std::vector<Point>& s) {
+  std::vector<Point> ret;
+  for(auto& p : s) {
+    auto kept = true;
+    for(auto& q : ret) {
+      if(dominates(q, p) || q == p) {
+	kept = false;
+	break;
+      }
+    }
+    if(!kept) continue;
+    ret.erase(std::remove_if(ret.begin(), ret.end(), [&p](const Point& q) {
+	  return dominates(p, q);
+	}), ret.end());
+    ret.push_back(p);
+  }
+  return ret;
+}
+
+double Indicators::hypervolume(std::vector<Point> s) {
+  for(auto& p : s) {
+    for(auto& x : p) {
+      x = std::max(x, 0.0);
+    }
+  }
+  auto f = front(s);
+  return wfg(f);
+}
+
+bool Indicators::add(const Point& p) {
+  for(auto& q : points) {
+    if(dominates(q, p) || q == p) return false;
+  }
+  // Exclusive contribution of p: its box minus the part of it the
+  // archive already dominates
+  Point c(p.size());
+  for(auto k = 0u; k < p.size(); k++) {
+    c[k] = std::max(p[k], 0.0);
+  }
+  std::vector<Point> limited;
+  limited.reserve(points.size());
+  for(auto& q : points) {
+    Point l(p.size());
+    for(auto k = 0u; k < p.size(); k++) {
+      l[k] = std::max(std::min(c[k], q[k]), 0.0);
+    }
+    limited.push_back(std::move(l));
+  }
+  volume += box(c)-hypervolume(limited);
+  points.erase(std::remove_if(points.begin(), points.end(), [&p](const Point& q) {
+	return dominates(p, q);
+      }), points.end());
+  points.push_back(p);
+  return true;
+}
+
+void Indicators::update(const std::vector<Point>& population) {
+  auto f = front(population);
+  for(auto& p : f) {
+    add(p);
+  }
+  frontSize = f.size();
+  distance = igd(f);
+  history.push_back(volume);
+}
+
+double Indicators::igd(const std::vector<Point>& f) const {
+  if(points.empty() || f.empty()) return 0;
+  // Objectives are normalized by the largest archive values
+  auto d = points[0].size();
+  std::vector<double> scale(d, 0);
+  for(auto& p : points) {
+    for(auto k = 0u; k < d; k++) {
+      scale[k] = std::max(scale[k], std::fabs(p[k]));
+    }
+  }
+  for(auto& s : scale) {
+    if(s == 0) s = 1;
+  }
+  auto sum = 0.0;
+  for(auto& a : points) {
+    auto nearest = std::numeric_limits<double>::max();
+    for(auto& p : f) {
+      auto d2 = 0.0;
+      for(auto k = 0u; k < d; k++) {
+	auto x = (a[k]-p[k])/scale[k];
+	d2 += x*x;
+      }
+      nearest = std::min(nearest, d2);
+    }
+    sum += std::sqrt(nearest);
+  }
+  return sum/points.size();
+}
+
+/* Accessors */
+
+const std::vector<Indicators::Point>& Indicators::archive() const {
+  return points;
+}
+
+double Indicators::hypervolume() const {
+  return volume;
+}
+
+double Indicators::igd() const {
+  return distance;
+}
+
+size_t Indicators::lastFront() const {
+  return frontSize;
+}
+
+/* Stopping rule */
+
+bool Indicators::stalled(double epsilon, size_t window) const {
+  if(history.size() <= window) return false;
+  auto before = history[history.size()-1-window];
+  return history.back()-before < epsilon*history.back();
+}
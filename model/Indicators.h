@@ -0,0 +1,126 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * \file Indicators.h
+ * \brief Indicators class header.
+ * \author Florian Galinier
+ * \version 0.1
+ * \date 19/10/26
+ *
+ * Quality indicators of Pareto fronts across generations.
+ *
+ */
+
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/**
+ * \class Indicators
+ * \brief Hypervolume of the best front found and IGD of the current
+ * front.
+ *
+ * Objectives are maximized. The archive holds every non-dominated
+ * point found so far; its hypervolume (volume dominated by the archive,
+ * from the origin) is updated by the exclusive contribution of each
+ * inserted point, so a generation only costs the points it brings. The
+ * IGD of a front is the average distance of archive points to the
+ * nearest point of the front, in objectives normalized by the largest
+ * archive values.
+ *
+ * \author Florian Galinier
+ */
+class Indicators {
+ public:
+  typedef std::vector<double> Point;
+ private:
+  std::vector<Point> points;
+  double volume;
+  double distance;
+  size_t frontSize;
+  std::vector<double> history;
+ public:
+  Indicators();
+  /**
+   * Return true if a point dominates another one (greater or equal
+   * everywhere, greater once).
+   * \param p The first point.
+   * \param q The second point.
+   * \return true iff p dominates q.
+   */
+  static bool dominates(const Point& p, const Point& q);
+  /**
+   * Return the non-dominated points of a set (without duplicates).
+   * \param s The points.
+   * \return The non-dominated points.
+   */
+  static std::vector<Point> front(const std::vector<Point>& s);
+  /**
+   * Return the hypervolume of a set of points, from the origin
+   * (negative coordinates count as 0).
+   * \param s The points, of the same dimension.
+   * \return The hypervolume.
+   */
+  static double hypervolume(std::vector<Point> s);
+  /**
+   * Insert a point in the archive, unless it is dominated by (or equal
+   * to) an archive point; archive points it dominates are removed.
+   * \param p The point.
+   * \return true iff the point was inserted.
+   */
+  bool add(const Point& p);
+  /**
+   * Record a generation: its front is added to the archive, then the
+   * hypervolume of the archive and the IGD of the front are recorded.
+   * \param population The points of the individuals of the generation.
+   */
+  void update(const std::vector<Point>& population);
+  /**
+   * Return the IGD of a front against the archive.
+   * \param f The front.
+   * \return The IGD (0 if the archive is empty).
+   */
+  double igd(const std::vector<Point>& f) const;
+  /**
+   * Return the archive.
+   * \return The non-dominated points found so far.
+   */
+  const std::vector<Point>& archive() const;
+  /**
+   * Return the hypervolume of the archive.
+   * \return The hypervolume.
+   */
+  double hypervolume() const;
+  /**
+   * Return the IGD of the front of the last generation.
+   * \return The IGD.
+   */
+  double igd() const;
+  /**
+   * Return the size of the front of the last generation.
+   * \return The number of non-dominated points of the generation.
+   */
+  size_t lastFront() const;
+  /**
+   * Return true if the hypervolume of the archive has improved by less
+   * than a ratio over a number of generations.
+   * \param epsilon The ratio (0.01 for 1%).
+   * \param window The number of generations.
+   * \return true iff more than window generations are recorded and the
+   * relative improvement over the last window ones is below epsilon.
+   */
+  bool stalled(double epsilon, size_t window) const;
+};
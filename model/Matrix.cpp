@@ -13,119 +13,319 @@
  */
 
 #include "Matrix.h"
+#include "FixedMatrix.h"
+#include "utils/Format.h"
+#include <cstring>
 #include <limits>
+#include <stdexcept>
 
-Matrix::Matrix(size_t t): m(t,std::vector<double>(t,0.f)) {}
+// Vector kernels are local to this file, the ABI of vector arguments
+// does not matter
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace {
+  /* Vectors of 32 bytes (one AVX register, or two SSE registers) */
+  template <typename T>
+  struct Simd {
+    typedef T V __attribute__((vector_size(32)));
+    static const size_t width = 32/sizeof(T);
+    static inline void load(V& v, const T* p) {
+      std::memcpy(&v, p, sizeof(V));
+    }
+    static inline void store(T* p, const V& v) {
+      std::memcpy(p, &v, sizeof(V));
+    }
+  };
+
+  /* res[k] = op(a[k],b[k]), op being generic (vectors and scalars) */
+  template <typename T, typename Op>
+  void apply(T* res, const T* a, const T* b, size_t n, Op op) {
+    typedef Simd<T> S;
+    typename S::V va, vb;
+    size_t k = 0;
+    for(; k + S::width <= n; k += S::width) {
+      S::load(va, a+k);
+      S::load(vb, b+k);
+      S::store(res+k, op(va, vb));
+    }
+    for(; k < n; k++) {
+      res[k] = op(a[k], b[k]);
+    }
+  }
+
+  /* Relation (GREATER|LESS bits) of a to b, stops when incomparable */
+  template <typename T>
+  int relation(const T* a, const T* b, size_t n, T tolerance) {
+    typedef Simd<T> S;
+    typename S::V va, vb, d;
+    int ret = 0;
+    size_t k = 0;
+    for(; ret != 3 && k + S::width <= n; k += S::width) {
+      S::load(va, a+k);
+      S::load(vb, b+k);
+      d = va - vb;
+      auto gt = d > tolerance;
+      auto lt = d < -tolerance;
+      for(size_t l = 0; l < S::width; l++) {
+	ret |= (gt[l] ? 1 : 0) | (lt[l] ? 2 : 0);
+      }
+    }
+    for(; ret != 3 && k < n; k++) {
+      auto dk = a[k] - b[k];
+      ret |= ((dk > tolerance) ? 1 : 0) | ((dk < -tolerance) ? 2 : 0);
+    }
+    return ret;
+  }
+
+  template <typename T>
+  double sum(const T* p, size_t n) {
+    typedef Simd<T> S;
+    typename S::V acc = {}, v;
+    size_t k = 0;
+    for(; k + S::width <= n; k += S::width) {
+      S::load(v, p+k);
+      acc += v;
+    }
+    double ret = 0;
+    for(size_t l = 0; l < S::width; l++) {
+      ret += acc[l];
+    }
+    for(; k < n; k++) {
+      ret += p[k];
+    }
+    return ret;
+  }
+
+  template <typename T>
+  double minimum(const T* p, size_t n, double init) {
+    typedef Simd<T> S;
+    auto ret = init;
+    size_t k = 0;
+    if(n >= S::width) {
+      typename S::V acc, v;
+      S::load(acc, p);
+      for(k = S::width; k + S::width <= n; k += S::width) {
+	S::load(v, p+k);
+	acc = (v < acc) ? v : acc;
+      }
+      for(size_t l = 0; l < S::width; l++) {
+	ret = (acc[l] < ret) ? acc[l] : ret;
+      }
+    }
+    for(; k < n; k++) {
+      ret = (p[k] < ret) ? p[k] : ret;
+    }
+    return ret;
+  }
+
+  /* Call fixed(std::integral_constant<size_t,N>()) for the sizes with a
+     FixedMatrix kernel, dynamic() for others */
+  template <typename F, typename D>
+  auto dispatch(size_t n, F fixed, D dynamic) -> decltype(dynamic()) {
+    switch(n) {
+    case 2: return fixed(std::integral_constant<size_t,2>());
+    case 3: return fixed(std::integral_constant<size_t,3>());
+    case 5: return fixed(std::integral_constant<size_t,5>());
+    default: return dynamic();
+    }
+  }
+}
+
+Matrix::Matrix(size_t t): n(t), c(t ? t*(t-1)/2 : 0), local() {
+  if(c > localCount) {
+    heap.assign(c, Value(0));
+    m = heap.data();
+  }
+  else m = local;
+}
+
+Matrix::Matrix(const Matrix& m2): Matrix(m2.n) {
+  std::copy(m2.m, m2.m+c, m);
+}
+
+Matrix& Matrix::operator=(const Matrix& m2) {
+  if(this != &m2) {
+    n = m2.n;
+    c = m2.c;
+    if(c > localCount) {
+      heap.assign(m2.m, m2.m+c);
+      m = heap.data();
+    }
+    else {
+      heap.clear();
+      std::copy(m2.m, m2.m+c, local);
+      m = local;
+    }
+  }
+  return *this;
+}
 
 Matrix::~Matrix() {}
 
 bool Matrix::operator!() const {
-  auto res = true;
-  for(auto& l : m) {
-    for(auto& c : l) {
-      res &= (c > -0.0001 && c < 0.0001);
-      if(!res) return res;
-    }
+  for(auto k = 0u; k < c; k++) {
+    if(!(m[k] > -0.0001 && m[k] < 0.0001)) return false;
   }
-  return res;
+  return true;
 }
 
 bool Matrix::isPositive() const {
-  auto res = true;
-  for(auto& l : m) {
-    for(auto& c : l) {
-      res &= (c >= 0);
-      if(!res) return res;
-    }
+  for(auto k = 0u; k < c; k++) {
+    if(!(m[k] >= 0)) return false;
   }
-  return res;
+  return true;
 }
 
-inline void Matrix::set(size_t i,size_t j,double v) {
-  m[i][j] = v;
+void Matrix::set(size_t i,size_t j,double v) {
+  if(i == j)
+    throw std::out_of_range("Try to set diagonal element ("+std::to_string(i)+","+std::to_string(j)+") of Matrix.");
+  m[(i < j) ? index(i,j) : index(j,i)] = v;
 }
 
-Matrix* Matrix::operator-(const Matrix& m2) {
-  if(m2.m.size() != m.size())
+void Matrix::checkSize(const Matrix& m2, const char* operation) const {
+  if(m2.n != n)
     throw
-      std::invalid_argument("Two matrices of substraction must be of same dimensions: "+
-			    std::to_string(m.size())+"x"+
-			    std::to_string(m.size())+" and "+
-			    std::to_string(m2.m.size())+"x"+
-			    std::to_string(m2.m.size())+
+      std::invalid_argument(std::string("Two matrices of ")+operation+
+			    " must be of same dimensions: "+
+			    std::to_string(n)+"x"+
+			    std::to_string(n)+" and "+
+			    std::to_string(m2.n)+"x"+
+			    std::to_string(m2.n)+
 			    " were provided.");
-  auto ret = new Matrix(m.size());
-  auto i = 0;
-  for(auto& l : m) {
-    auto j = 0;
-    for(auto c : l) {
-      auto b = m2[i][j];
-      ret->set(i,j,c-b);
-      j++;
-    }
-    i++;
-  }
+}
+
+Matrix* Matrix::operator-(const Matrix& m2) const {
+  checkSize(m2, "substraction");
+  auto ret = new Matrix(n);
+  subtract(*this, m2, *ret);
   return ret;
 }
 
-bool Matrix::operator>(const Matrix& m) {
-  auto c = *this - m;
-  return c->isPositive() && !(!(*c));
+void Matrix::subtract(const Matrix& m1, const Matrix& m2, Matrix& res) {
+  m1.checkSize(m2, "substraction");
+  m1.checkSize(res, "substraction");
+  apply(res.m, m1.m, m2.m, res.c,
+	[](auto x, auto y) { return x - y; });
+}
+
+void Matrix::add(const Matrix& m1, const Matrix& m2, Matrix& res) {
+  m1.checkSize(m2, "addition");
+  m1.checkSize(res, "addition");
+  apply(res.m, m1.m, m2.m, res.c,
+	[](auto x, auto y) { return x + y; });
+}
+
+void Matrix::axpy(double a, const Matrix& m1, const Matrix& m2, Matrix& res) {
+  m1.checkSize(m2, "addition");
+  m1.checkSize(res, "addition");
+  auto f = static_cast<Value>(a);
+  apply(res.m, m1.m, m2.m, res.c,
+	[f](auto x, auto y) { return f*x + y; });
+}
+
+Matrix& Matrix::operator-=(const Matrix& m2) {
+  subtract(*this, m2, *this);
+  return *this;
+}
+
+Matrix& Matrix::operator+=(const Matrix& m2) {
+  add(*this, m2, *this);
+  return *this;
+}
+
+Matrix& Matrix::operator*=(double a) {
+  for(auto k = 0u; k < c; k++) {
+    m[k] *= a;
+  }
+  return *this;
+}
+
+Matrix::Relation Matrix::compare(const Matrix& m1, const Matrix& m2,
+				 double tolerance) {
+  m1.checkSize(m2, "comparison");
+  return triangleCompare(m1.n, m1.m, m2.m, tolerance);
+}
+
+Matrix::Relation Matrix::triangleCompare(size_t n, const Value* a,
+					 const Value* b, double tolerance) {
+  auto t = static_cast<Value>(tolerance);
+  return static_cast<Relation>
+    (dispatch(n,
+	      [=](auto N) { return FixedMatrix<decltype(N)::value>::relation(a, b, t); },
+	      [=]() { return relation(a, b, n*(n-1)/2, t); }));
+}
+
+bool Matrix::dominates(const Matrix& m2) const {
+  return compare(*this, m2) == GREATER;
 }
 
-bool Matrix::operator>=(const Matrix& m) {
-  auto c = *this - m;
-  auto res = c->isPositive();
-  delete c;
-  return res;
+bool Matrix::operator>(const Matrix& m) const {
+  // No element less, and the difference is not null (same tolerance
+  // as operator!)
+  return compare(*this, m) == GREATER &&
+    (compare(*this, m, 0.0001) & GREATER);
 }
 
-const std::vector<double>& Matrix::operator[](size_t i) const {
-  if(i>=m.size())
+bool Matrix::operator>=(const Matrix& m) const {
+  return !(compare(*this, m) & LESS);
+}
+
+Matrix::Row Matrix::operator[](size_t i) const {
+  if(i>=n)
     throw std::out_of_range("Try to access to unknown "+std::to_string(i)+"th element of Matrix.");
-  return m[i];
+  return Row(*this, i);
+}
+
+const Matrix::Value* Matrix::data() const {
+  return m;
+}
+
+size_t Matrix::count() const {
+  return c;
 }
 
 double Matrix::min() const {
-  double ret = std::numeric_limits<float>::max();
-  for(auto i = 0u;i<m.size();i++) {
-    for(auto j = std::begin(m[i])+i+1, end = std::end(m[i]);
-	j<end;j++) {
-      ret = (*j < ret)?*j:ret;
-    }
-  }
-  return ret;
+  return triangleMin(n, m);
 }
 
 double Matrix::average() const {
-  double avg = 0;
-  for(auto& l : m) {
-    for(auto& c : l) {
-      avg += c;
-    }
-  }
-  return avg/((m.size()*(m.size()-1))/2);
+  return triangleSum(n, m)/c;
+}
+
+double Matrix::triangleSum(size_t n, const Value* p) {
+  return dispatch(n,
+		  [=](auto N) { return FixedMatrix<decltype(N)::value>::sum(p); },
+		  [=]() { return sum(p, n*(n-1)/2); });
+}
+
+double Matrix::triangleMin(size_t n, const Value* p) {
+  auto init = std::numeric_limits<float>::max();
+  return dispatch(n,
+		  [=](auto N) { return FixedMatrix<decltype(N)::value>::min(p, init); },
+		  [=]() { return minimum(p, n*(n-1)/2, init); });
 }
 
 double Matrix::lineAverage(int line) const {
+  // No fixed kernel: a line has too few elements for unrolling to gain
+  size_t l = line;
   double avg = 0;
-  for(auto i=0;i<static_cast<int>(size());i++) {
-    if(i < line) {
-      avg += m[i][line];
-    }
-    else if (i > line) {
-      avg += m[line][i];
-    }
+  // Column line above the diagonal, then row line after it
+  for(auto i = 0u; i < l; i++) {
+    avg += m[index(i,l)];
   }
-  return avg/size();
+  if(l+1 < n)
+    avg += sum(m+index(l,l+1), n-l-1);
+  return avg/n;
 }
 
 std::string Matrix::to_string() const {
   std::string ret;
-  for(auto& l : m) {
+  ret.reserve(n*(n*10+4));
+  for(auto i = 0u; i < n; i++) {
     ret += "[ ";
-    for(auto& c : l) {
-      ret += std::to_string(c)+" ";
+    for(auto j = 0u; j < n; j++) {
+      Format::appendFixed(ret, get(i,j));
+      ret += ' ';
     }
     ret += "]\n";
   }
@@ -134,11 +334,13 @@ std::string Matrix::to_string() const {
 
 std::string Matrix::to_csv_string() const {
   std::string ret;
-  for(auto& l : m) {
-    for(auto c = std::begin(l), end = std::end(l);c < end;c++) {
-      ret += std::to_string(*c)+((c != end-1)?",":"");
+  ret.reserve(n*n*10);
+  for(auto i = 0u; i < n; i++) {
+    for(auto j = 0u; j < n; j++) {
+      Format::appendFixed(ret, get(i,j));
+      if(j != n-1) ret += ',';
     }
-    ret += "\n";
+    ret += '\n';
   }
   return ret;
 }
@@ -154,5 +356,5 @@ std::ostream& operator<<(std::ostream& os, const Matrix& m) {
 }
 
 size_t Matrix::size() const {
-  return m.size();
+  return n;
 }
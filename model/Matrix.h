@@ -27,6 +27,7 @@
 #include <vector>
 #include <iostream>
 #include "utils/Logger.h"
+#include "utils/Aligned.h"
 
 /**
  * \class Matrix
@@ -35,17 +36,83 @@
  * This class implement is used for store results of multi-dimensionnal
  * score.
  *
+ * Scores are distances between models (or individuals): the matrix is
+ * symmetric with a null diagonal, so only its strict upper triangle is
+ * stored, row by row, in one aligned buffer. Element (j,i) is element
+ * (i,j). Elements are double, or float if compiled with MATRIX_FLOAT
+ * (generation files store doubles whatever the element type).
+ * Up to 5x5, elements are kept in the object and reductions use the
+ * kernels of FixedMatrix.
+ *
  * \author Florian Galinier
  */
 class Matrix {
+ public:
+#ifdef MATRIX_FLOAT
+  typedef float Value;
+#else
+  typedef double Value;
+#endif
+  /**
+   * \brief Elementwise relation between two matrices, see compare().
+   *
+   * GREATER (resp. LESS) is set if at least one element of the first
+   * matrix is greater (resp. less) than the one of the second.
+   */
+  enum Relation {
+    EQUAL = 0,
+    GREATER = 1,
+    LESS = 2,
+    INCOMPARABLE = 3,
+  };
+  /**
+   * \class Matrix::Row
+   * \brief A row of a matrix, read through operator[].
+   */
+  class Row {
+   private:
+    const Matrix& m;
+    size_t i;
+   public:
+    Row(const Matrix& m, size_t i): m(m), i(i) {}
+    Value operator[](size_t j) const { return m.get(i,j); }
+    size_t size() const { return m.size(); }
+  };
  private:
-  std::vector<std::vector<double>> m;
+  size_t n;
+  size_t c;
+  /* Elements of small matrices (up to 5x5) are kept in the object */
+  static const size_t localCount = 10;
+  Value local[localCount];
+  std::vector<Value,AlignedAllocator<Value>> heap;
+  Value* m;
+  /**
+   * Return the offset of element (i,j), i < j, in the buffer.
+   */
+  size_t index(size_t i,size_t j) const {
+    return i*(2*n-i-1)/2 + (j-i-1);
+  }
+  /**
+   * Throw if m2 is not of the same size.
+   */
+  void checkSize(const Matrix& m2, const char* operation) const;
  public:
   /**
    * Create a new square matrix of size t.
    * \param t The number of rows and columns.
    */
   Matrix(size_t t);
+  /**
+   * Copy a matrix.
+   * \param m2 The matrix to copy.
+   */
+  Matrix(const Matrix& m2);
+  /**
+   * Copy a matrix.
+   * \param m2 The matrix to copy.
+   * \return The current matrix.
+   */
+  Matrix& operator=(const Matrix& m2);
   /**
    * Destructor for Matrix class.
    */
@@ -64,37 +131,144 @@ class Matrix {
   /**
    * Substract two matrices and return the resulting matrix.
    * \param m2 The matrix to substract to current one.
-   * \return A new pointer Matrix that is the result of substraction.
+   * \return A new pointer Matrix that is the result of substraction,
+   * owned by the caller (see subtract() to reuse a matrix).
+   */
+  Matrix* operator-(const Matrix& m2) const;
+  /**
+   * Write m1 - m2 into res. res may be m1 or m2.
+   * \param m1 The first operand.
+   * \param m2 The second operand.
+   * \param res The result.
+   * \throw std::invalid_argument if sizes differ.
+   */
+  static void subtract(const Matrix& m1, const Matrix& m2, Matrix& res);
+  /**
+   * Write m1 + m2 into res. res may be m1 or m2.
+   * \param m1 The first operand.
+   * \param m2 The second operand.
+   * \param res The result.
+   * \throw std::invalid_argument if sizes differ.
    */
-  Matrix* operator-(const Matrix& m2);
+  static void add(const Matrix& m1, const Matrix& m2, Matrix& res);
   /**
-   * Change element at position (i,j).
+   * Write a*m1 + m2 into res. res may be m1 or m2.
+   * \param a The factor.
+   * \param m1 The first operand.
+   * \param m2 The second operand.
+   * \param res The result.
+   * \throw std::invalid_argument if sizes differ.
+   */
+  static void axpy(double a, const Matrix& m1, const Matrix& m2, Matrix& res);
+  /**
+   * Substract a matrix to current one.
+   * \param m2 The matrix to substract.
+   * \return The current matrix.
+   */
+  Matrix& operator-=(const Matrix& m2);
+  /**
+   * Add a matrix to current one.
+   * \param m2 The matrix to add.
+   * \return The current matrix.
+   */
+  Matrix& operator+=(const Matrix& m2);
+  /**
+   * Multiply current matrix by a scalar.
+   * \param a The factor.
+   * \return The current matrix.
+   */
+  Matrix& operator*=(double a);
+  /**
+   * Compare two matrices elementwise in one pass. Elements that differ
+   * by less than tolerance are equal.
+   * \param m1 The first matrix.
+   * \param m2 The second matrix.
+   * \param tolerance The tolerance.
+   * \return The relation of m1 to m2.
+   * \throw std::invalid_argument if sizes differ.
+   */
+  static Relation compare(const Matrix& m1, const Matrix& m2,
+			  double tolerance = 0);
+  /**
+   * Compare two strict upper triangles of n×n matrices (stored as in
+   * Matrix), see compare().
+   * \param n The size of matrices.
+   * \param a The first triangle.
+   * \param b The second triangle.
+   * \param tolerance The tolerance.
+   * \return The relation of a to b.
+   */
+  static Relation triangleCompare(size_t n, const Value* a, const Value* b,
+				  double tolerance = 0);
+  /**
+   * Return the sum of a strict upper triangle of a n×n matrix.
+   * \param n The size of matrix.
+   * \param p The triangle.
+   * \return The sum of elements.
+   */
+  static double triangleSum(size_t n, const Value* p);
+  /**
+   * Return the minimum of a strict upper triangle of a n×n matrix.
+   * \param n The size of matrix.
+   * \param p The triangle.
+   * \return The minimum of elements.
+   */
+  static double triangleMin(size_t n, const Value* p);
+  /**
+   * Return true if current matrix dominates m2, i.e. if all its
+   * elements are greater or equal and one is greater.
+   * \param m2 The matrix to compare.
+   * \return true iff current matrix dominates m2.
+   */
+  bool dominates(const Matrix& m2) const;
+  /**
+   * Change element at position (i,j) (and (j,i)).
    * \param i The number of the row.
    * \param j The number of the column.
    * \param v The new value of Matrix at (i,j).
+   * \throw std::out_of_range if i == j (the diagonal is null).
    */
   virtual void set(size_t i,size_t j,double v);
+  /**
+   * Return element at position (i,j), without bounds checking.
+   * \param i The number of the row.
+   * \param j The number of the column.
+   * \return The value of Matrix at (i,j).
+   */
+  Value get(size_t i,size_t j) const {
+    return (i < j) ? m[index(i,j)] : (j < i) ? m[index(j,i)] : Value(0);
+  }
   /**
    * Compare two matrices and return true only if current matrix
    * is greater or equal than m2.
    * \param m2 The matrix to compare.
    * \return true only if current matrix is greater or equal than m2.
    */
-  virtual bool operator>=(const Matrix& m2);
+  virtual bool operator>=(const Matrix& m2) const;
   /**
    * Compare two matrices and return true only if current matrix
    * is greater than m2.
    * \param m2 The matrix to compare.
    * \return true only if current matrix is greater than m2.
    */
-  virtual bool operator>(const Matrix& m2);
+  virtual bool operator>(const Matrix& m2) const;
   /**
    * Accessor for line of Matrix. Allow to access to matrix
    * element by using [][].
    * \param i The line to access.
    * \return The ith line.
    */
-  const std::vector<double>& operator[](size_t i) const;
+  Row operator[](size_t i) const;
+  /**
+   * Return the strict upper triangle, row by row.
+   * \return The stored elements.
+   */
+  const Value* data() const;
+  /**
+   * Return the number of stored elements (t(t-1)/2).
+   * \return The number of elements of the strict upper triangle.
+   */
+  size_t count() const;
   /**
    * Return an average value of upper triangular matrix.
    * \return Average value of upper triangular matrix.
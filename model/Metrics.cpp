@@ -0,0 +1,124 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Metrics.h"
+#include "Model.h"
+#include "Xcsp.h"
+#include <cmath>
+#include <sstream>
+
+/* Constructors */
+
+GenerationMetrics::GenerationMetrics(unsigned int generation):
+  generation(generation), crossover(0), mutation(0), validation(0),
+  evaluation(0), sorting(0), selection(0), output(0), stats(0), total(0),
+  offspring(0), crossLost(0), repaired(0), mutations(0), mutLost(0),
+  feasible(0), launches(0), dotHits(0), normHits(0), networkHits(0),
+  counters(), mark() {}
+
+/* Measures */
+
+void GenerationMetrics::start() {
+  auto m = Model::toolMetrics();
+  launches = m.launches;
+  dotHits = m.dotHits;
+  normHits = m.normHits;
+  networkHits = Xcsp::cacheHits();
+  if(PerfCounters::enabled())
+    mark = PerfCounters::read();
+}
+
+void GenerationMetrics::stop() {
+  auto m = Model::toolMetrics();
+  launches = m.launches - launches;
+  dotHits = m.dotHits - dotHits;
+  normHits = m.normHits - normHits;
+  networkHits = Xcsp::cacheHits() - networkHits;
+}
+
+void GenerationMetrics::count(Phase p) {
+  if(!PerfCounters::enabled()) return;
+  auto now = PerfCounters::read();
+  for(auto e = 0u; e < PerfCounters::events; e++) {
+    counters[p][e] += now[e]-mark[e];
+  }
+  mark = now;
+}
+
+/* Stream methods */
+
+std::vector<std::pair<std::string,std::string>> GenerationMetrics::fields() const {
+  auto ms = [](double d) {
+    std::ostringstream oss;
+    oss.precision(3);
+    oss << std::fixed << d;
+    return oss.str();
+  };
+  std::vector<std::pair<std::string,std::string>> ret = {
+    {"generation", std::to_string(generation)},
+    {"crossover_ms", ms(crossover)},
+    {"mutation_ms", ms(mutation)},
+    {"validation_ms", ms(validation)},
+    {"evaluation_ms", ms(evaluation)},
+    {"sorting_ms", ms(sorting)},
+    {"selection_ms", ms(selection)},
+    {"output_ms", ms(output)},
+    {"stats_ms", ms(stats)},
+    {"total_ms", ms(total)},
+    {"offspring", std::to_string(offspring)},
+    {"cross_lost", std::to_string(crossLost)},
+    {"repaired", std::to_string(repaired)},
+    {"mutations", std::to_string(mutations)},
+    {"mut_lost", std::to_string(mutLost)},
+    {"feasible", std::to_string(feasible)},
+    {"launches", std::to_string(launches)},
+    {"dot_hits", std::to_string(dotHits)},
+    {"norm_hits", std::to_string(normHits)},
+    {"network_hits", std::to_string(networkHits)},
+  };
+  // Hardware counts, columns of counted events only
+  if(PerfCounters::enabled()) {
+    const char* names[phases] =
+      {"breeding", "mutations", "evaluation", "selection", "statistics", "outputs"};
+    for(auto p = 0u; p < phases; p++) {
+      for(auto e = 0u; e < PerfCounters::events; e++) {
+	auto event = static_cast<PerfCounters::Event>(e);
+	if(PerfCounters::counted(event))
+	  ret.push_back({std::string(names[p])+"_"+PerfCounters::name(event),
+			 std::to_string(std::llround(counters[p][e]))});
+      }
+    }
+  }
+  return ret;
+}
+
+std::string GenerationMetrics::header() {
+  std::string ret;
+  for(auto& f : GenerationMetrics().fields()) {
+    ret += (ret.empty() ? "" : ",") + f.first;
+  }
+  return ret+"\n";
+}
+
+std::string GenerationMetrics::to_string(Format format) const {
+  std::string ret;
+  for(auto& f : fields()) {
+    if(format == CSV)
+      ret += (ret.empty() ? "" : ",") + f.second;
+    else
+      ret += (ret.empty() ? "{" : ",") + ("\""+f.first+"\":") + f.second;
+  }
+  return ret + (format == JSONL ? "}\n" : "\n");
+}
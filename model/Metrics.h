@@ -0,0 +1,137 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * \file Metrics.h
+ * \brief GenerationMetrics class header.
+ * \author Florian Galinier
+ * \version 0.1
+ * \date 19/10/26
+ *
+ * Performance record of a generation (output/metrics.csv|jsonl).
+ *
+ */
+
+#pragma once
+#include "utils/PerfCounters.h"
+#include "utils/Probes.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * \class GenerationMetrics
+ * \brief Durations of the phases of a generation and counters of the
+ * work done.
+ *
+ * Durations are in milliseconds, wall clock. Counters of external
+ * tools and caches are differences of the process counters between the
+ * start and the end of the generation.
+ *
+ * When PerfCounters are enabled, the hardware counts of each phase of
+ * the generation are recorded too.
+ *
+ * \author Florian Galinier
+ */
+class GenerationMetrics {
+ public:
+  /**
+   * \brief Output format.
+   */
+  enum Format {
+    CSV,
+    JSONL
+  };
+  /**
+   * \brief Phase of a generation, for hardware counts.
+   */
+  enum Phase {
+    BREEDING,
+    MUTATIONS,
+    EVALUATION,
+    SELECTION,
+    STATISTICS,
+    OUTPUTS
+  };
+  static const size_t phases = 6;
+  /* Durations are laps of the probes clock (see PROBE_LAP) */
+  typedef Probes::Clock Clock;
+  unsigned int generation;
+  /* Durations (ms) */
+  double crossover;
+  double mutation;
+  double validation;
+  double evaluation;
+  double sorting;
+  double selection;
+  double output;
+  double stats;
+  double total;
+  /* Breeding counters */
+  size_t offspring;
+  size_t crossLost;
+  size_t repaired;
+  size_t mutations;
+  size_t mutLost;
+  size_t feasible;
+  /* Process counters */
+  size_t launches;
+  size_t dotHits;
+  size_t normHits;
+  size_t networkHits;
+  /* Hardware counts of phases (see PerfCounters) */
+  std::array<PerfCounters::Values,phases> counters;
+  /**
+   * Create a record with zero durations and counters.
+   * \param generation The generation.
+   */
+  GenerationMetrics(unsigned int generation = 0);
+  /**
+   * Record the current process counters (see Model::toolMetrics), to
+   * be subtracted by stop().
+   */
+  void start();
+  /**
+   * Replace process counters by their increase since start().
+   */
+  void stop();
+  /**
+   * Add the hardware counts since start() or the previous call to a
+   * phase (no effect if PerfCounters are not enabled).
+   * \param p The phase.
+   */
+  void count(Phase p);
+  /**
+   * Return the fields of the record, in output order.
+   * \return The (name,value) pairs.
+   */
+  std::vector<std::pair<std::string,std::string>> fields() const;
+  /**
+   * Return the CSV header line.
+   * \return The header line (with end of line).
+   */
+  static std::string header();
+  /**
+   * Return the record in a format.
+   * \param format The format.
+   * \return The record line (with end of line).
+   */
+  std::string to_string(Format format) const;
+ private:
+  PerfCounters::Values mark;
+};
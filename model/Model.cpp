@@ -24,26 +24,36 @@
 #include <future>
 #include <cerrno>
 #include <cstring>
+#include <limits>
+#include <chrono>
+#include <stdexcept>
+#include <mutex>
 #include "NSGAII.h"
+#include "Xcsp.h"
+#include "utils/Scratch.h"
+#include "utils/Format.h"
+#include "utils/Probes.h"
 
 /* Constructors */
 
+ModelArtifacts::ModelArtifacts():
+  dot(""), norm(std::numeric_limits<double>::quiet_NaN()), lock() {}
+
 Model::Model(): genes(std::make_shared<Genes>()),
 		domains(std::make_shared<Domains>()),
-		change(true) {}
+		artifacts(std::make_shared<ModelArtifacts>()) {}
 
-Model::Model(const Model& m): genes(std::make_shared<Genes>()),
-			      domains(std::make_shared<Domains>()),
+Model::Model(const Model& m): genes(m.genes),
+			      domains(m.domains),
 			      xcsp(m.xcsp), mm(m.mm), root(m.root),
-			      grimm(m.grimm), dot(""),
-			      change(true) {
- 
-  for(auto i=0u; i<m.genes->size(); i++) {
-    genes->push_back(m.genes->at(i));
-    domains->push_back(m.domains->at(i));
-  }
-}
+			      grimm(m.grimm),
+			      artifacts(m.artifacts) {}
 
+Model::Model(const Model& m, GenesPtr genes, DomainsPtr domains):
+  genes(genes), domains(domains),
+  xcsp(m.xcsp), mm(m.mm), root(m.root),
+  grimm(m.grimm),
+  artifacts(std::make_shared<ModelArtifacts>()) {}
 
 Model::Model(std::string genesFile): Model() {
   std::ifstream infile(genesFile);
@@ -75,24 +85,40 @@ Model::Model(std::string genesFile): Model() {
     root = tmp[3];
   }
   
-  pugi::xml_document doc;
-  doc.load_file(xcsp.c_str());
-  auto inst = doc.child("instance");
-  auto variables = inst.select_nodes("//variable"); 
+  domains = loadDomains(xcsp);
+  assert(domains->size() == genes->size());
+}
 
-  for(auto var : variables) {
-    std::string dom = var.node().attribute("domain").value();
-    auto req = "//domain[@name='"+dom+"']";
-    auto domVal = inst.select_nodes(req.c_str());
-    std::istringstream parser(domVal[0].node().child_value());
-    std::string tmp;
-    IntervalVector<int> d;
-    while(parser >> tmp) {
-         d.add(tmp);
-    }
-    domains->push_back(d);
+namespace {
+  /* Counters of loadDomains calls, of external tools and artifact
+     caches */
+  std::atomic<size_t> loadRequests(0), toolLaunches(0), dotHits(0), normHits(0);
+
+  /* Time (ms) since the launch of an external tool */
+  double launchTime(std::chrono::steady_clock::time_point t) {
+    return std::chrono::duration<double,std::milli>
+      (std::chrono::steady_clock::now()-t).count();
   }
-  assert(domains->size() == genes->size());
+}
+
+DomainsPtr Model::loadDomains(const std::string& xcsp) {
+  loadRequests++;
+  // Domains are those of the shared network, kept alive by the pointer
+  auto network = Xcsp::load(xcsp);
+  // A truncated or malformed file would give partial domains
+  if(!network->isValid())
+    throw std::runtime_error("Can not read the XCSP file "+xcsp+".");
+  return DomainsPtr(network, &network->getDomains());
+}
+
+LoadMetrics Model::loadMetrics() {
+  auto c = Xcsp::loadCounters();
+  return {loadRequests, c.files, c.parsed, c.domains, c.variables,
+      c.parseTime};
+}
+
+ToolMetrics Model::toolMetrics() {
+  return {toolLaunches, dotHits, normHits};
 }
 
 Model::~Model() {}
@@ -100,19 +126,38 @@ Model::~Model() {}
 /* Accessors */
 
 void Model::setVal(GenesPtr v) {
-  change = true;
+  invalidate();
   genes = v;
 }
 
-GenesPtr Model::getVal() const {
+ConstGenesPtr Model::getVal() const {
   return genes;
 }
 
+Genes& Model::editVal() {
+  if(genes.use_count() > 1)
+    genes = std::make_shared<Genes>(*genes);
+  invalidate();
+  return *genes;
+}
+
 void Model::setDomains(DomainsPtr d) {
-  change = true;
+  invalidate();
   domains = d;
 }
 
+void Model::invalidate() {
+  if(artifacts.use_count() > 1) {
+    // Artifacts are still valid for the other models
+    artifacts = std::make_shared<ModelArtifacts>();
+    return;
+  }
+  if(artifacts->dot != "")
+    std::remove(artifacts->dot.c_str());
+  artifacts->dot = "";
+  artifacts->norm = std::numeric_limits<double>::quiet_NaN();
+}
+
 DomainsPtr Model::getDomains() const {
   return domains;
 }
@@ -120,16 +165,17 @@ DomainsPtr Model::getDomains() const {
 /* Evaluation operation */
 
 std::string Model::generateDotFile(int i) {
-  if(!change) return dot;
-  change = false;
-  std::string outfileChrono = NSGAII::dir+"/jvmconsuption/jvmconsuption"+std::to_string(NSGAII::gen);
-
+  // Models sharing genes share the dot file, generate it only once
+  std::lock_guard<std::mutex> guard(artifacts->lock);
+  auto& dot = artifacts->dot;
   if(dot != "") {
-    auto cmd = "rm "+dot;
-    system(cmd.c_str());
+    dotHits++;
+    return dot;
   }
+  std::string outfileChrono = NSGAII::dir+"/jvmconsuption/jvmconsuption"+std::to_string(NSGAII::gen);
   
-  auto tmp = "tmp"+std::to_string(i);
+  Scratch val;
+  auto& tmp = val.path();
   std::ofstream of(tmp);
   of << *this;
   of.flush();
@@ -149,7 +195,9 @@ std::string Model::generateDotFile(int i) {
   
   //  std::string cmd = "java -jar grimm4ga3.jar -n=6 -d=0.2 -val=tmp";
 
-  //  auto t1 = std::chrono::high_resolution_clock::now();  
+  toolLaunches++;
+  PROBE_TIMER("grimm");
+  auto t1 = std::chrono::steady_clock::now();
   if(!(in = popen(cmd.c_str(), "r"))) {
     errno = 0;
     std::cerr<<"Error: "<<strerror(errno)<<std::endl;
@@ -157,12 +205,10 @@ std::string Model::generateDotFile(int i) {
     //exit(2);
   }
 
-  int jvmLaunch;
   auto first = true;
   while(fgets(buff, sizeof(buff), in) != NULL) {
     if(first) {
-      //     auto t2 = std::chrono::high_resolution_clock::now();  
-      //jvmLaunch = std::chrono::duration_cast<std::chrono::milliseconds>(t2-t1).count();
+      PROBE_VALUE("grimm first output (ms)", launchTime(t1));
       first = false;
     }
     //std::cout<<buff << std::endl;
@@ -193,14 +239,12 @@ std::string Model::generateDotFile(int i) {
 	//system(("mv "+fileName+" "+outdirGen).c_str());
 	//std::string rawfileName = fileName.substr(fileName.find("/"),fileName.length());
   //dot = outdirGen+rawfileName;
-  //auto t2 = std::chrono::high_resolution_clock::now();
 	dot = fileName;
 
 	//display of dot file and corresponding values
 	//std::cout << dot << std::endl << *this << std::endl;
   
   Logger l(outfileChrono,std::ios_base::app);
-  //l<<"dot "<<jvmLaunch<<" "<<std::chrono::duration_cast<std::chrono::milliseconds>(t2-t1).count()<<"\n";
   return dot;
 }
 
@@ -246,26 +290,16 @@ float Model::levenshteinDistance(const Model& m1,const Model& m2) {
 float Model::cosineDistance(const Model& m1, const Model& m2) {
 
   auto num = 0.0;
-  auto g1 = m1.getVal();
-  auto g2 = m2.getVal();
-  if(g1->size() > g2->size()) {
-    auto tmp = g1;
-    g1 = g2;
-    g2 = tmp;
-  }
+  auto& g1 = *m1.genes;
+  auto& g2 = *m2.genes;
+  auto size = std::min(g1.size(), g2.size());
 
-  long double den1 = 0.0;
-  long double den2 = 0.0;
+  // Norms are cached with the genes
+  long double den1 = m1.squaredNorm();
+  long double den2 = m2.squaredNorm();
 
-  for(size_t i = 0;i<g1->size();i++) {
-    num += (g1->at(i) * g2->at(i));
-  }
-
-  for(size_t i = 0;i<g1->size();i++) {
-    den1 += (g1->at(i) * g1->at(i));
-  }
-  for(size_t i = 0;i<g2->size();i++) {
-    den2 += (g2->at(i) * g2->at(i));
+  for(size_t i = 0;i<size;i++) {
+    num += (g1[i] * g2[i]);
   }
 
   //  std::cout<<"\tDistance entre \n"<<m1<<"\net\n"<<m2<<"\n= "<<1-num/(sqrt(den1)*sqrt(den2))<<std::endl;
@@ -273,6 +307,19 @@ float Model::cosineDistance(const Model& m1, const Model& m2) {
   return 1-(num/(sqrt(den1)*sqrt(den2)));
 }
 
+double Model::squaredNorm() const {
+  double norm = artifacts->norm;
+  if(norm != norm) { // NaN, not computed yet
+    norm = 0.0;
+    for(auto g : *genes) {
+      norm += static_cast<double>(g) * g;
+    }
+    artifacts->norm = norm;
+  }
+  else normHits++;
+  return norm;
+}
+
 std::tuple<float,float,float> Model::evaluateExtern(Model& m1,Model& m2) {
   auto fut1 = std::async(std::launch::async,&Model::generateDotFile,&m1,0);
   auto fut2 = std::async(std::launch::async,&Model::generateDotFile,&m2,1);
@@ -288,7 +335,9 @@ std::tuple<float,float,float> Model::evaluateExtern(Model& m1,Model& m2) {
   
   FILE *in;
   char buff[512];
-  auto t1 = std::chrono::high_resolution_clock::now();  
+  toolLaunches++;
+  PROBE_TIMER("gDistances");
+  auto t1 = std::chrono::steady_clock::now();
   if(!(in = popen(cmd.c_str(),"r"))) {
     errno = 0;
     std::cerr<<strerror(errno)<<std::endl;
@@ -300,8 +349,9 @@ std::tuple<float,float,float> Model::evaluateExtern(Model& m1,Model& m2) {
   auto first = true;
   while(fgets(buff, sizeof(buff), in) != NULL) {
     if(first) {
-      auto t2 = std::chrono::high_resolution_clock::now();  
-      jvmLaunch = std::chrono::duration_cast<std::chrono::milliseconds>(t2-t1).count();
+      auto launch = launchTime(t1);
+      PROBE_VALUE("gDistances first output (ms)", launch);
+      jvmLaunch = launch;
       first = false;
     }
     std::string tmp = buff;
@@ -349,15 +399,38 @@ std::tuple<float,float,float> Model::evaluateExtern(Model& m1,Model& m2) {
     }
   }
   pclose(in);
-  auto t2 = std::chrono::high_resolution_clock::now();  
   auto outfile = NSGAII::dir+"/jvmconsuption/jvmconsuption"+std::to_string(NSGAII::gen);
   
   Logger l(outfile,std::ios_base::app);
-  l<<"ev "<<jvmLaunch<<" "<<std::chrono::duration_cast<std::chrono::milliseconds>(t2-t1).count()<<"\n";
+  l<<"ev "<<jvmLaunch<<" "<<static_cast<int>(launchTime(t1))<<"\n";
   return std::make_tuple(hamming,centrality,levenshtein);
 }
 
+std::shared_ptr<const Xcsp> Model::getXcsp() const {
+  return Xcsp::load(xcsp);
+}
+
 bool Model::isValid() const {
+  auto net = getXcsp();
+  if(net->isSupported() && net->size() == genes->size())
+    return net->check(*genes);
+  return isValidExtern();
+}
+
+bool Model::repair() {
+  auto net = getXcsp();
+  if(!net->isSupported() || net->size() != genes->size())
+    return false;
+  if(net->check(*genes))
+    return true;
+  Genes g(*genes);
+  auto valid = net->repair(g);
+  if(valid)
+    editVal() = std::move(g);
+  return valid;
+}
+
+bool Model::isValidExtern() const {
   pugi::xml_document doc;
   doc.load_file(xcsp.c_str());
   auto inst = doc.child("instance");
@@ -401,12 +474,15 @@ bool Model::isValid() const {
     */
   }
   constraints.attribute("nbConstraints").set_value(nb+i);
-  doc.save_file("tmp.xml");
+  Scratch instance(".xml");
+  doc.save_file(instance.path().c_str());
 
   FILE *in;
   char buff[512];
-  //  auto t1 = std::chrono::high_resolution_clock::now();  
-  if(!(in = popen("java -jar abssol.jar tmp.xml","r"))) {
+  toolLaunches++;
+  PROBE_TIMER("abssol");
+  auto t1 = std::chrono::steady_clock::now();
+  if(!(in = popen(("java -jar abssol.jar "+instance.path()).c_str(),"r"))) {
     errno = 0;
     std::cerr<<strerror(errno)<<std::endl;
     return false;
@@ -414,11 +490,9 @@ bool Model::isValid() const {
 
   auto ret = false;
   auto first = true;
-  auto jvmLaunch = 0;
   while(fgets(buff, sizeof(buff), in) != NULL) {
     if(first) {
-      //  auto t2 = std::chrono::high_resolution_clock::now();  
-      //jvmLaunch = std::chrono::duration_cast<std::chrono::milliseconds>(t2-t1).count();
+      PROBE_VALUE("abssol first output (ms)", launchTime(t1));
       first = false;
     }
     std::string tmp = buff;
@@ -431,11 +505,9 @@ bool Model::isValid() const {
   }
   pclose(in);
   
-  //auto t2 = std::chrono::high_resolution_clock::now();  
   auto outfile = NSGAII::dir+"/jvmconsuption/jvmconsuption"+std::to_string(NSGAII::gen);
   
   Logger l(outfile,std::ios_base::app);
-  //l<<"sol "<<jvmLaunch<<" "<<std::chrono::duration_cast<std::chrono::milliseconds>(t2-t1).count()<<"\n";
   return ret;
 }
 
@@ -455,83 +527,60 @@ const std::vector<std::string> explode(const std::string& s, const char& c)
 }
 
 std::string Model::generateDotFileScaffold(std::string fileName){
-	//récupération du xcsp lié au modèle
-	pugi::xml_document doc;
-  doc.load_file(xcsp.c_str());
-  //parcours du xcsp jusqu'au noeud contenant les labels des variables
-  auto inst = doc.child("instance");
-  auto variables = inst.select_nodes("//variable");
-  
-  //récupération du vecteur contenant les valeurs des variables
-  GenesPtr genVal = this->getVal();
-  
-  //création du fichier output
-  std::ofstream output(fileName);
-  
-  //edition du fichier
+  // Variable names of the instance (shared network, not re-parsed)
+  auto net = getXcsp();
+  auto& variables = net->getVariables();
+  auto& genVal = *genes;
+
+  std::ostringstream output;
   output << "Graph mon_graphe{" << std::endl;
-  
-  //les arêtes sont représentés par un ensemble de 3 données il faut identifier quand on est en train de gérer un trio ou non
+
+  // An edge is a trio of variables (weight, EVin, EVout)
   bool trio = false;
-  
-  //stock le poid de l'arête en cours de traitement
   int weight = 0;
-  
-  //la ligne en construction
   std::string line;
-  
-  //indice de la variable en cours de traitement
-  int i = 0;
-  
-  for(auto var : variables){
-  	//récupération du label de la variable
-  	std::string val = var.node().attribute("name").value();
-  	//parser le label
-  	std::vector<std::string> vector{explode(val, '_')};
-  	if(!vector.empty()){
-  		//si le label indique un noeud
-  		if(vector.at(3) == "vertices"){
-  			//ajout au fichier
-  			output << std::stoi(vector.at(4)) << std::endl;
-  		}
-  		//si le label indique une arête et est le premier d'un triplet de valeur (weight)
-  		if(vector.at(1) == "Edge" && vector.at(3) == "weight"){
-  			//récupération du point de l'arête
-  			weight = (*(genVal.get()))[i];
-				trio = true;
-  		}
-  		else{
-  			//si on est en train de traiter un triplet
-  			if(trio){
-  				//on récupére la valeur associée
-  				int gen = (*(genVal.get()))[i];
-  				//si c'est le noeud point de départ
-  				if(vector.at(3) == "EVin"){
-						line = std::to_string(gen) + " -> ";
-  				}
-  				//si c'est le noeud d'arrivé
-  				if(vector.at(3) == "EVout"){
-  					if(weight > 0){
-							output << line + std::to_string(gen) + "[label=\""+std::to_string(weight)+"\",weight=\"" + std::to_string(weight) + "\"];" << std::endl;
-						}
-						//réinitialisation du poid
-						weight = 0;
-						trio = false;
-  				}
-				}
-  		}
-  	}
-  	i++;
+
+  for(auto i = 0u; i < variables.size() && i < genVal.size(); i++) {
+    auto vector = explode(variables[i], '_');
+    if(vector.size() < 4) continue;
+    // Vertex
+    if(vector[3] == "vertices" && vector.size() > 4) {
+      output << std::stoi(vector[4]) << std::endl;
+    }
+    // First value of an edge trio (weight)
+    if(vector[1] == "Edge" && vector[3] == "weight") {
+      weight = genVal[i];
+      trio = true;
+    }
+    else if(trio) {
+      if(vector[3] == "EVin") {
+	line = std::to_string(genVal[i]) + " -> ";
+      }
+      if(vector[3] == "EVout") {
+	if(weight > 0) {
+	  output << line + std::to_string(genVal[i]) + "[label=\""+std::to_string(weight)+"\",weight=\"" + std::to_string(weight) + "\"];" << std::endl;
+	}
+	weight = 0;
+	trio = false;
+      }
+    }
   }
   output << "}";
-  output.close();
+  std::ofstream file(fileName);
+  file << output.str();
   return "";
 }
 
+void Model::writeChr(const std::string& fileName) const {
+  std::ofstream output(fileName);
+  output << to_string() << "\n" << xcsp << "\n" << grimm << "\n"
+	 << mm << "\n" << root << std::endl;
+}
+
 /* Comparison operators */
 
 bool Model::operator==(const Model& b) {
-  return *(this->genes) == *(b.genes);
+  return this->genes == b.genes || *(this->genes) == *(b.genes);
 }
 
 bool Model::operator!=(const Model& b) {
@@ -541,11 +590,17 @@ bool Model::operator!=(const Model& b) {
 /* String methods and operators */
 
 std::string Model::to_string() const {
-  std::ostringstream oss;
+  std::string ret;
+  appendTo(ret);
+  return ret;
+}
+
+void Model::appendTo(std::string& s) const {
+  s.reserve(s.size()+4*genes->size());
   for(auto a : *genes) {
-    oss << a << " ";
+    Format::appendInteger(s, a);
+    s += ' ';
   }
-  return oss.str();
 }
 
 std::ostream& operator<<(std::ostream& os,const Model& m) {
@@ -26,8 +26,11 @@
 #pragma once
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <mutex>
 #include <lib/pugixml-1.8/src/pugixml.hpp>
 #include "utils/IntervalVector.h"
+#include "Xcsp.h"
 
 /** 
  * In our problem, a gene vector is a vector of int.
@@ -38,6 +41,10 @@ typedef std::vector<int> Genes;
  * Smart pointer to a genes vector.
  */
 typedef std::shared_ptr<Genes> GenesPtr;
+/**
+ * Smart pointer to a read-only genes vector.
+ */
+typedef std::shared_ptr<const Genes> ConstGenesPtr;
 /**
  * A vector of all domains. For all i in {0..Genes.size()},
  * Domains[i] = domains of Genes[i]
@@ -46,10 +53,80 @@ typedef std::vector<IntervalVector<int>> Domains;
 /**
  * Smart pointer to a domains vector.
  */
-typedef std::shared_ptr<Domains> DomainsPtr;
+typedef std::shared_ptr<const Domains> DomainsPtr;
 
 class GAChromosom;
 
+/**
+ * \struct ModelArtifacts
+ * \brief Artifacts derived from a genes vector.
+ *
+ * Models that share a genes vector (copies not modified since)
+ * share their artifacts too, so a dot file or a norm computed for
+ * one of them is reused by the others.
+ */
+struct ModelArtifacts {
+  /**
+   * Path of the generated dot file ("" if not generated).
+   */
+  std::string dot;
+  /**
+   * Squared euclidean norm of genes (NaN if not computed).
+   */
+  std::atomic<double> norm;
+  /**
+   * Lock for dot file generation.
+   */
+  std::mutex lock;
+  ModelArtifacts();
+};
+/**
+ * Smart pointer to model artifacts.
+ */
+typedef std::shared_ptr<ModelArtifacts> ModelArtifactsPtr;
+
+/**
+ * \struct LoadMetrics
+ * \brief Counters of XCSP domain loading (see Model::loadMetrics).
+ */
+struct LoadMetrics {
+  /**
+   * Number of loadDomains calls.
+   */
+  size_t requests;
+  /**
+   * Number of distinct XCSP paths requested, and of distinct files
+   * parsed (see Xcsp::load).
+   */
+  size_t files;
+  size_t parsed;
+  /**
+   * Number of domains and variables in parsed files.
+   */
+  size_t domains;
+  size_t variables;
+  /**
+   * Time spent reading and parsing (ms, summed over threads).
+   */
+  double parseTime;
+};
+
+/**
+ * \struct ToolMetrics
+ * \brief Counters of external tools and caches (see Model::toolMetrics).
+ */
+struct ToolMetrics {
+  /**
+   * Number of external processes launched (grimm, gDistances, abssol).
+   */
+  size_t launches;
+  /**
+   * Number of dot files and norms reused from shared artifacts.
+   */
+  size_t dotHits;
+  size_t normHits;
+};
+
 /**
  * \class Model
  * \brief Class that represent a model.
@@ -58,6 +135,9 @@ class GAChromosom;
  * Due to the fact that a model can be composed by more than a model,
  * we create a class that encapsulate the idea of model.
  *
+ * Genes are copy-on-write: copies of a Model share genes, domains and
+ * artifacts until one of them is modified through editVal or setVal.
+ *
  * \author Florian Galinier
  */
 class Model {
@@ -69,20 +149,44 @@ class Model {
   std::string mm;
   std::string root;
   std::string grimm;
-  std::string dot;
-  bool change;
+  ModelArtifactsPtr artifacts;
+  /**
+   * Drop artifacts of current genes (the dot file is removed if no
+   * other Model uses it).
+   */
+  void invalidate();
+  /**
+   * Check validity with the external solver (abssol).
+   * \return true if Model is valid, elsewhere false.
+   */
+  bool isValidExtern() const;
  public:
   /**
    * Create a new empty Model.
    */
   Model();
   /**
-   * Create a Model that is a copy of Model m.
+   * Create a Model that is a copy of Model m. Genes, domains and
+   * artifacts are shared until one of the models is modified.
    * \param m The Model to copy.
    */
   Model(const Model& m);
   /**
-   * Create a new model with data from input file. 
+   * Create a Model by moving Model m.
+   * \param m The Model to move.
+   */
+  Model(Model&& m) noexcept = default;
+  /**
+   * Create a Model with metadata (XCSP, meta-model, grimm file)
+   * of Model m and the given genes and domains.
+   * \param m The Model providing metadata.
+   * \param genes The genes of the new Model.
+   * \param domains The domains of the new Model.
+   */
+  Model(const Model& m, GenesPtr genes, DomainsPtr domains);
+  /**
+   * Create a new model with data from input file. Domains are shared
+   * with the other models of the same XCSP file (see loadDomains).
    * \param genesFile The file path that contains vector value for model.
    */
   Model(std::string genesFile);
@@ -90,6 +194,18 @@ class Model {
    * Model destructor.
    */
   virtual ~Model() noexcept;
+  /**
+   * Copy assignment (genes, domains and artifacts are shared with m).
+   * \param m The Model to copy.
+   * \return The current Model.
+   */
+  Model& operator=(const Model& m) = default;
+  /**
+   * Move assignment.
+   * \param m The Model to move.
+   * \return The current Model.
+   */
+  Model& operator=(Model&& m) noexcept = default;
   
   /**
    * Change actual value of Model
@@ -100,9 +216,16 @@ class Model {
   
   /**
    * Return actual value of Model
+   * \return The current value of Model (read-only, may be shared)
+   */
+  virtual ConstGenesPtr getVal() const;
+
+  /**
+   * Return a writable value of Model. Genes are copied first if
+   * they are shared, and artifacts are invalidated.
    * \return The current value of Model
    */
-  virtual GenesPtr getVal() const;
+  virtual Genes& editVal();
 
   /**
    * Change actual value of Model
@@ -117,6 +240,29 @@ class Model {
    */
   virtual DomainsPtr getDomains() const;
 
+  /**
+   * Return the domains of variables of an XCSP file, those of its
+   * shared network (see Xcsp::load).
+   * \param xcsp The XCSP file path.
+   * \return The variable domains.
+   * \throw std::runtime_error if the file can not be read entirely (see
+   * Xcsp::isValid).
+   */
+  static DomainsPtr loadDomains(const std::string& xcsp);
+
+  /**
+   * Return the counters of loadDomains since the start of the process.
+   * \return The load metrics.
+   */
+  static LoadMetrics loadMetrics();
+
+  /**
+   * Return the counters of external tools and caches since the start
+   * of the process.
+   * \return The tool metrics.
+   */
+  static ToolMetrics toolMetrics();
+
   /**
    * Take two models and return an evaluation of the distance between them.
    * \param m1 First model to test.
@@ -150,14 +296,47 @@ class Model {
    * \return The levenshtein distance between the two models.
    */
   static float levenshteinDistance(const Model& m1,const Model& m2);
+
+  /**
+   * Return the squared euclidean norm of genes (cached).
+   * \return The squared norm of genes.
+   */
+  double squaredNorm() const;
   
+  /**
+   * Write the dot graph of a scaffold model (vertices and weighted
+   * edges named after XCSP variables).
+   * \param fileName The dot file path.
+   * \return An empty string.
+   */
   std::string generateDotFileScaffold(std::string fileName);
+  /**
+   * Write the model in a file that Model(std::string) reads back.
+   * \param fileName The .chr file path.
+   */
+  void writeChr(const std::string& fileName) const;
 
   /**
-   * Check if the Model is a valid model or not.
+   * Return the constraint network of the Model XCSP file (shared by
+   * all models of the same file).
+   * \return The constraint network.
+   */
+  virtual std::shared_ptr<const Xcsp> getXcsp() const;
+
+  /**
+   * Check if the Model is a valid model or not. The check is done
+   * natively when the XCSP constraints are supported, with the
+   * external solver elsewhere.
    * \return true if Model is valid, elsewhere false.
    */
   virtual bool isValid() const;
+
+  /**
+   * Try to make the Model valid by changing values of variables of
+   * violated constraints (see Xcsp::repair).
+   * \return true if Model is valid after repair, elsewhere false.
+   */
+  virtual bool repair();
   
   /**
    * Compare two models and return true if models are equals.
@@ -176,9 +355,16 @@ class Model {
    * \return A string that represent current model.
    */
   virtual std::string to_string() const;
+  /**
+   * Append the string that represent current model (see to_string()).
+   * \param s The string where to append.
+   */
+  void appendTo(std::string& s) const;
 
   /**
-   * Generate a dot file from actual model.
+   * Generate a dot file from actual model (the model values are passed
+   * to the external tool through a scratch file).
+   * \param i Index of the model in its evaluation (unused).
    * \return The dot file path.
    */
   virtual std::string generateDotFile(int i);
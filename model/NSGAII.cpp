@@ -15,69 +15,88 @@
 #include "Population.h"
 #include "NSGAII.h"
 #include "GAChromosom.h"
-#include <ga/garandom.h>
+#include "utils/Probes.h"
+#include "utils/Random.h"
+#include "utils/ThreadPool.h"
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <chrono>
 #include <sys/stat.h>
 #include <fstream>
+#include <memory>
 
 int NSGAII::fitness = NSGAII::Fitness::AVG;
 std::string NSGAII::dir = "default";
 unsigned int NSGAII::gen = 0;
 unsigned int NSGAII::maxGen = 100;
-
-NSGAII::NSGAII(const GAPopulation& p, unsigned int pm): GASimpleGA(p), extraStats(), popMult(pm) {
+unsigned int NSGAII::keyframe = 1;
+int NSGAII::exportFrequency = -1;
+GenerationMetrics::Format NSGAII::metricsFormat = GenerationMetrics::Format::CSV;
+double NSGAII::convergence = -1;
+unsigned int NSGAII::window = 20;
+
+NSGAII::NSGAII(const GAPopulation& p, unsigned int pm): GASimpleGA(p), extraStats(), popMult(pm),
+  genWriter(NSGAII::keyframe), metricsStarted(false) {
   assert(pm > 0);
 }
 
 NSGAII::~NSGAII() {}
 
-bool NSGAII::dominate(MatrixPtr m1, MatrixPtr m2) {
-  if(!*m1 && !*m2)
+bool NSGAII::dominate(const Objectives& o1, const Objectives& o2,
+		      Objectives::Kind k) {
+  if(o1.isNull(k) && o2.isNull(k))
     return true;
-  MatrixPtr sc1, sc2;
-  // Case where the fitness is not dist (not 0b0000)
+  // Case where the fitness is not dist (not 0b0000), objectives are
+  // the average (or average + min) and the min of distances
   if(NSGAII::fitness) {
-    sc1 = std::make_shared<Matrix>(2);
-    sc2 = std::make_shared<Matrix>(2);
+    double f1[2] = {0,0}, f2[2] = {0,0};
     // Case where fitness is the sum of min and average
     if(NSGAII::fitness & Fitness::MINAVG) {
-      sc1->set(0,1,m1->average() + m1->min());
-      sc2->set(0,1,m2->average() + m2->min());
+      f1[0] = o1.average(k) + o1.min(k);
+      f2[0] = o2.average(k) + o2.min(k);
     }
     else {
       // If average
       if(NSGAII::fitness & Fitness::AVG) {
-	sc1->set(0,1,m1->average());
-	sc2->set(0,1,m2->average());
+	f1[0] = o1.average(k);
+	f2[0] = o2.average(k);
       }
       // If min
       if(NSGAII::fitness & Fitness::MIN) {
-	sc1->set(0,0,m1->min());
-	sc2->set(0,0,m2->min());
+	f1[1] = o1.min(k);
+	f2[1] = o2.min(k);
       }
     }
-  }
-  else {
-    // If no fitness, the distances matrices are used
-    // as fitness matrices.
-    sc1 = m1;
-    sc2 = m2;
-  }
-  auto dom = false;
-  // Use the previous matrices as a fitness matrices
-  for(auto i=0u;i<sc1->size();i++) {
-    auto m1Row = (*sc1)[i];
-    auto m2Row = (*sc2)[i];
-    for(auto j=0u;j<m1Row.size();j++) {
-      if(m1Row[j] < m2Row[j])
+    auto dom = false;
+    for(auto k = 0; k < 2; k++) {
+      if(f1[k] < f2[k])
 	return false;
-      if(m1Row[j] > m2Row[j])
+      if(f1[k] > f2[k])
 	dom = true;
     }
+    return dom;
   }
-  return dom;
+  // If no fitness, the distances matrices are used
+  // as fitness matrices.
+  return o1.dominates(k, o2);
+}
+
+Indicators::Point NSGAII::point(const Objectives& o) {
+  Indicators::Point ret;
+  for(auto k = 0; k < Objectives::KINDS; k++) {
+    if(!(GAChromosom::method & (1 << k))) continue;
+    auto kind = static_cast<Objectives::Kind>(k);
+    if(NSGAII::fitness & Fitness::MINAVG)
+      ret.push_back(o.average(kind) + o.min(kind));
+    else {
+      if(!NSGAII::fitness || (NSGAII::fitness & Fitness::AVG))
+	ret.push_back(o.average(kind));
+      if(!NSGAII::fitness || (NSGAII::fitness & Fitness::MIN))
+	ret.push_back(o.min(kind));
+    }
+  }
+  return ret;
 }
 
 std::shared_ptr<std::vector<std::vector<int>>>
@@ -99,15 +118,15 @@ NSGAII::fastNonDominatedSort() {
     for(auto j = 0;j < pop->size();j++) {
       if(j != i) {
 	GAChromosom& q = static_cast<GAChromosom&>(pop->individual(j));
-	auto pscore = p.score();
-	auto qscore = q.score();
-	if(dominate(pscore[0],qscore[0]) &&
-	   dominate(pscore[1],qscore[1]) &&
-	   dominate(pscore[2],qscore[2]))
+	auto& pscore = p.score();
+	auto& qscore = q.score();
+	if(dominate(pscore,qscore,Objectives::COSINE) &&
+	   dominate(pscore,qscore,Objectives::HAMMING) &&
+	   dominate(pscore,qscore,Objectives::CENTRALITY))
 	  s[i].push_back(j);
-	else if(dominate(qscore[0],pscore[0]) &&
-	   dominate(qscore[1],pscore[1]) &&
-	   dominate(qscore[2],pscore[2]))
+	else if(dominate(qscore,pscore,Objectives::COSINE) &&
+	   dominate(qscore,pscore,Objectives::HAMMING) &&
+	   dominate(qscore,pscore,Objectives::CENTRALITY))
 	  n[i]++;
       }
     }
@@ -146,17 +165,18 @@ std::map<size_t,double> NSGAII::crowdingDistanceAssignment(std::vector<int>& f)
 
   // For each distances
   for(auto d = 0u; d < 3; d++) {
+    auto kind = static_cast<Objectives::Kind>(d);
     for(auto l = 0u; l < Chromosom::getNbModels()-1; l++) {
       for(auto c = l + 1; c < Chromosom::getNbModels();c++) {
 	// Order individuals by the fitness
 	std::sort(f.begin(),
 		  f.end(),
-		  [this,l,c,d](auto& i,auto& j){
+		  [this,l,c,kind](auto& i,auto& j){
 		    return
-		      (*static_cast<GAChromosom&>(pop->individual(i))
-		       .score()[d])[l][c] <
-			 (*static_cast<GAChromosom&>(pop->individual(j))
-			  .score()[d])[l][c];
+		      static_cast<GAChromosom&>(pop->individual(i))
+		       .score().get(kind,l,c) <
+			 static_cast<GAChromosom&>(pop->individual(j))
+			  .score().get(kind,l,c);
 		  });
 
 	// Extremum are kept
@@ -166,20 +186,20 @@ std::map<size_t,double> NSGAII::crowdingDistanceAssignment(std::vector<int>& f)
 	// Give a crowding distance according to distance to
 	// other individuals.
 	for(size_t i = 1;i<(f.size()-1);i++) {
-	  if(((*static_cast<::Population*>(pop)
-	       ->best(l,c).score()[d])[l][c] -
-	      (*static_cast<::Population*>(pop)
-	       ->worst(l,c).score()[d])[l][c]))
-	    r[f[i]] += (((*static_cast
+	  if((static_cast<::Population*>(pop)
+	       ->best(l,c).score().get(kind,l,c) -
+	      static_cast<::Population*>(pop)
+	       ->worst(l,c).score().get(kind,l,c)))
+	    r[f[i]] += ((static_cast
 			  <GAChromosom&>(pop->individual(f[i+1]))
-			  .score()[d])[l][c] -
-			 (*static_cast
+			  .score().get(kind,l,c) -
+			 static_cast
 			  <GAChromosom&>(pop->individual(f[i-1]))
-			  .score()[d])[l][c]) /
-			((*static_cast<::Population*>(pop)
-			  ->best(l,c).score()[d])[l][c] -
-			 (*static_cast<::Population*>(pop)
-			  ->worst(l,c).score()[d])[l][c]));
+			  .score().get(kind,l,c)) /
+			(static_cast<::Population*>(pop)
+			  ->best(l,c).score().get(kind,l,c) -
+			 static_cast<::Population*>(pop)
+			  ->worst(l,c).score().get(kind,l,c)));
 	}
  
       }
@@ -193,10 +213,11 @@ void NSGAII::clustering(::Population* popr,
 			::Population* p,
 			unsigned int popSize,
 			MatrixPtr res) {
+  Random::Scope rs(Random::Stream::CLUSTERING, gen);
   std::vector<int> centers;
   // Random select centers
   while (centers.size() < popSize) {
-    int c = GARandomInt(0,res->size()-1);
+    int c = Random::randomInt(0,res->size()-1);
     if(std::find(centers.begin(), centers.end(), c) == centers.end())
       centers.push_back(c);
   }
@@ -213,7 +234,7 @@ void NSGAII::clustering(::Population* popr,
     for(auto l = 0u; l < res->size(); l++) {
       if(std::find(centers.begin(), centers.end(), l) ==
 	 centers.end()) { // If individual is not a center
-	auto& line = (*res)[l];
+	auto line = (*res)[l];
 	auto min = std::numeric_limits<double>::max();
 	auto minIndex = -1;
 	// For each centers, find the nearest.
@@ -231,7 +252,7 @@ void NSGAII::clustering(::Population* popr,
     // Assign new centers
     std::vector<double> max(res->size());
     for(auto l = 0u; l < res->size(); l++) {
-      auto& line = (*res)[l];
+      auto line = (*res)[l];
       max[l] = 0;
       for(auto i = 0u; i < line.size(); i++) {
 	if(clusters[i] != clusters[l]) {
@@ -258,7 +279,9 @@ void NSGAII::clustering(::Population* popr,
 void NSGAII::step() {
   // Initialization of the generation
   gen++;
-  auto t1 = std::chrono::high_resolution_clock::now();
+  // Phases are timed once, by laps of a single clock feeding both
+  // metrics and probes
+  auto t1 = GenerationMetrics::Clock::now();
   std::cout<<gen;
   std::cout.flush();
   auto p = new ::Population();
@@ -267,9 +290,13 @@ void NSGAII::step() {
   auto mutLost = 0;
   auto nbMut = 0;
   auto lost = 0;
-  auto tMin = std::numeric_limits<double>::max();
-  auto tMax = 0.;
-  auto tMoy = 0.;
+  auto repaired = 0;
+  // Durations (ms) of validations and evaluations, for mutstate
+  Probes::Stat checks;
+  auto nbCross = 0u;
+  GenerationMetrics metrics(gen);
+  metrics.start();
+  auto phase = t1;
 
   // Until offspring population is not filled
   while(static_cast<unsigned int>(p->size()) < popMult*popSize) {
@@ -281,10 +308,16 @@ void NSGAII::step() {
       dad = popr->select();
     }
 
-    // Crossover to obtain childs
+    // Crossover to obtain childs (each crossover has its own stream,
+    // so that offspring do not depend on the breeding thread)
     GAGenome* sis = new GAChromosom;
     GAGenome* bro = new GAChromosom;
-    stats.numcro += (*scross)(dad, mom, sis, bro);
+    {
+      auto tc = GenerationMetrics::Clock::now();
+      Random::Scope rs(Random::Stream::CROSSOVER, gen, nbCross++);
+      stats.numcro += (*scross)(dad, mom, sis, bro);
+      metrics.crossover += PROBE_LAP("crossover", tc);
+    }
     if(GAChromosom::crossover != GAChromosom::Cross::INTRA) {
       p->add(sis);
       p->add(bro);
@@ -292,14 +325,20 @@ void NSGAII::step() {
     else {
       // Crossover is intra, we need to check if generated models
       // are valid models.
-      auto tm = std::chrono::high_resolution_clock::now();
+      // Invalid children are repaired rather than discarded.
+      auto tm = GenerationMetrics::Clock::now();
       auto sisValid = static_cast<GAChromosom*>(sis)->isValid();
       auto broValid = static_cast<GAChromosom*>(bro)->isValid();
-      auto tmend = std::chrono::high_resolution_clock::now();
-      auto dur = std::chrono::duration_cast<std::chrono::milliseconds>(tmend-tm).count();
-      tMin = (dur < tMin)?dur:tMin;
-      tMax = (dur > tMax)?dur:tMax;
-      tMoy += dur;
+      if(!sisValid || !broValid) {
+	Random::Scope rs(Random::Stream::REPAIR, gen, nbCross-1);
+	if(!sisValid && (sisValid = static_cast<GAChromosom*>(sis)->repair()))
+	  repaired++;
+	if(!broValid && (broValid = static_cast<GAChromosom*>(bro)->repair()))
+	  repaired++;
+      }
+      auto ms = PROBE_LAP("validation", tm);
+      checks.add(std::floor(ms));
+      metrics.validation += ms;
       if(sisValid)
 	p->add(sis);
       else
@@ -311,25 +350,36 @@ void NSGAII::step() {
     }
   }
 
+  PROBE_LAP("breeding", phase);
+  metrics.count(GenerationMetrics::BREEDING);
   std::cout<<".";
   std::cout.flush();
   
   auto i = 0;
+  auto tries = 0u;
   for(auto i=0;i<p->size();) {
     // Apply mutations to offspring population
     auto ind = new GAChromosom(*dynamic_cast<GAChromosom*>(&p->individual(i)));
-    auto mut = dynamic_cast<GAGenome*>(ind)->mutate(pMutation());
+    auto mut = 0;
+    {
+      auto tc = GenerationMetrics::Clock::now();
+      Random::Scope rs(Random::Stream::MUTATION, gen, i, tries++);
+      mut = dynamic_cast<GAGenome*>(ind)->mutate(pMutation());
+      metrics.mutation += PROBE_LAP("mutation", tc);
+    }
     if(mut) {
       nbMut++;
-      auto tm = std::chrono::high_resolution_clock::now();
-      auto valid = static_cast<GAChromosom&>(*ind).isValid(); 
-      auto tmend = std::chrono::high_resolution_clock::now();
-      auto dur = std::chrono::duration_cast<std::chrono::milliseconds>(tmend-tm).count();
-      tMin = (dur < tMin)?dur:tMin;
-      tMax = (dur > tMax)?dur:tMax;
-      tMoy += dur;
+      auto tm = GenerationMetrics::Clock::now();
+      // Offspring of a feasibility-preserving mutation are valid
+      auto feasible = ind->isFeasible();
+      auto valid = feasible || ind->isValid();
+      auto ms = PROBE_LAP("validation", tm);
+      metrics.validation += ms;
+      metrics.feasible += feasible;
+      checks.add(std::floor(ms));
       if(valid) {
 				i++;
+				tries = 0;
 				stats.nummut += mut;
 				popr->add(ind);
       }
@@ -340,25 +390,25 @@ void NSGAII::step() {
     else {
       popr->add(ind);
       i++;
+      tries = 0;
     }
   }
   
+  PROBE_LAP("mutations", phase);
+  metrics.count(GenerationMetrics::MUTATIONS);
   std::cout<<".";
   std::cout.flush();
 
   // Evaluation of population
-  auto tm = std::chrono::high_resolution_clock::now();
   MatrixPtr res;
   if(GAChromosom::getNbModels() == 1)
     res = popr->popEvaluate();
   else
     popr->evaluate();
-  auto tmend = std::chrono::high_resolution_clock::now();
-  auto dur = std::chrono::
-    duration_cast<std::chrono::milliseconds>(tmend-tm).count();
-  tMin = (dur < tMin)?dur:tMin;
-  tMax = (dur > tMax)?dur:tMax;
-  tMoy += dur;
+  auto ms = PROBE_LAP("population evaluation", phase);
+  checks.add(std::floor(ms));
+  metrics.evaluation += ms;
+  metrics.count(GenerationMetrics::EVALUATION);
 
   delete p;
   p = new ::Population();
@@ -369,6 +419,7 @@ void NSGAII::step() {
   else {
     // Case m > 1, we apply classical NSGA-II algorithm
     auto f = fastNonDominatedSort();
+    metrics.sorting += PROBE_LAP("non-dominated sort", phase);
     i = 0;
     while(p->size()+f->at(i).size()
 	  <= static_cast<unsigned int>(popSize)) {
@@ -393,49 +444,83 @@ void NSGAII::step() {
     }
   }
   
+  metrics.selection += PROBE_LAP("selection", phase);
+  metrics.count(GenerationMetrics::SELECTION);
   std::cout<<".";
   std::cout.flush();
 
   population(*p);
   stats.update(*p);
   extraStats.update(*p);
+  metrics.stats += PROBE_LAP("statistics", phase);
+  metrics.count(GenerationMetrics::STATISTICS);
   
   popr = static_cast<::Population*>(p);
   // Evaluation for statistics
-  tm = std::chrono::high_resolution_clock::now();
   if(GAChromosom::getNbModels() == 1)
     res = popr->popEvaluate();
   else
     popr->evaluate();
-  tmend = std::chrono::high_resolution_clock::now();
-  dur = std::chrono::
-    duration_cast<std::chrono::milliseconds>(tmend-tm).count();
-  tMin = (dur < tMin)?dur:tMin;
-  tMax = (dur > tMax)?dur:tMax;
-  tMoy += dur;
-
-	
+  ms = PROBE_LAP("population evaluation", phase);
+  checks.add(std::floor(ms));
+  metrics.evaluation += ms;
+  metrics.count(GenerationMetrics::EVALUATION);
+
+  // Quality indicators of the generation (m > 1: fronts of
+  // individuals), the run ends with this generation upon convergence
+  auto converged = false;
+  if(convergence >= 0 && GAChromosom::getNbModels() > 1) {
+    std::vector<Indicators::Point> points;
+    points.reserve(popr->size());
+    for(auto k = 0; k < popr->size(); k++) {
+      points.push_back(point(static_cast<GAChromosom&>(popr->individual(k)).score()));
+    }
+    indicators.update(points);
+    Logger li(NSGAII::dir+"/output/indicators",std::ios_base::app);
+    li<<gen<<" "<<indicators.hypervolume()<<" "<<indicators.igd()<<" "
+      <<indicators.lastFront()<<" "<<indicators.archive().size()<<"\n";
+    if(gen < maxGen && indicators.stalled(convergence, window)) {
+      converged = true;
+      maxGen = gen;
+      nGenerations(gen);
+    }
+    metrics.stats += PROBE_LAP("indicators", phase);
+    metrics.count(GenerationMetrics::STATISTICS);
+  }
 
   // Output population
   std::string outfile = NSGAII::dir+std::string("/output/gen")+std::to_string(gen);
 	
-  Logger l(outfile);
-  if(GAChromosom::getNbModels() == 1){
-    l << *res;
-	}
-	l << *popr;
+  {
+    PROBE_TIMER("generation file");
+    genWriter.write(outfile, gen, *popr,
+		    (GAChromosom::getNbModels() == 1) ? res.get() : nullptr);
+  }
 
   // Output mutation status
-  auto t2 = std::chrono::high_resolution_clock::now();  
+  auto t2 = GenerationMetrics::Clock::now();
   outfile = NSGAII::dir+std::string("/output/mutstate");
   Logger l2(outfile,std::ios_base::app);
   l2<<gen<<" "<<lost<<" "<<popMult*popSize<<" "<<
     nbMut<<" "<<mutLost<<" "<<
     std::chrono::duration_cast<std::chrono::milliseconds>(t2-t1).count()
-    <<" "<<tMin<<" "<<tMax<<" "<<tMoy<<" "<<tMoy/nbMut<<"\n";
+    <<" "<<checks.min<<" "<<(checks.count ? checks.max : 0)<<" "<<checks.sum
+    <<" "<<checks.sum/nbMut<<" "<<repaired<<"\n";
   
+  // Export models of requested generations
+  if(exportFrequency >= 0 &&
+     (gen == maxGen || (exportFrequency > 0 && !(gen % exportFrequency)))) {
+    PROBE_TIMER("model export");
+    exportGeneration(*popr, NSGAII::dir+"/output/dotgen"+std::to_string(gen));
+  }
+  metrics.output += PROBE_LAP("outputs", phase);
+  metrics.count(GenerationMetrics::OUTPUTS);
+
   delete p;
   std::cout<<"."<<std::endl;
+  if(converged)
+    std::cout<<"Converged: hypervolume improved by less than "<<convergence
+	     <<" over "<<window<<" generations"<<std::endl;
 
   // Each 5 generations, output statistics
   // TODO: Add possibility to change record frequence
@@ -443,81 +528,38 @@ void NSGAII::step() {
     std::string outfile = Statistics::outfile;
     Logger l(outfile);
     l << extraStats;
+    metrics.stats += PROBE_LAP("statistics", phase);
+    metrics.count(GenerationMetrics::STATISTICS);
   }
+
+  // Output performance metrics
+  metrics.stop();
+  metrics.offspring = popMult*popSize;
+  metrics.crossLost = lost;
+  metrics.repaired = repaired;
+  metrics.mutations = nbMut;
+  metrics.mutLost = mutLost;
+  metrics.total = PROBE_LAP("generation", t1);
+  auto csv = metricsFormat == GenerationMetrics::Format::CSV;
+  Logger l3(NSGAII::dir+"/output/metrics"+(csv ? ".csv" : ".jsonl"),
+	    metricsStarted ? std::ios_base::app : std::ios_base::out);
+  if(!metricsStarted && csv)
+    l3 << GenerationMetrics::header();
+  l3 << metrics.to_string(metricsFormat);
+  metricsStarted = true;
+  Probes::merge();
 }
 
 
-void NSGAII::generateDotGen(std::string metaModelDir, std::string genFile, std::string outputDir){
-		//récupération du fichier genX, output de mdea, contenant les vecteurs des individus
-	  std::ifstream file(genFile);
-	  //si on a pu ouvrir le fichier
-	  if(file){
-	  		//initialisation des variables nécessaires au du parcours du fichier
-	      std::string line;
-	      int vectorNumber=0;
-				//boucle de parcours
-	      while(getline(file, line)){
-	      		//si la ligne commence par un entier, c'est donc un vecteur
-	          if(isdigit(line[0])){
-	          		//création du dossier d'output
-								mkdir(outputDir.c_str(),0777);
-								//création du fichier chr stockant les informations sur le modèle de l'individu
-	          		std::string outputPath = outputDir+"/c"+std::to_string(vectorNumber).c_str()+".chr";
-	              std::ofstream output(outputPath);
-	              //insertion du vecteur dans le fichier
-	              output << line << std::endl;
-	              //initialisation du chemin vers le fichier xcsp
-								std::string metaModel = metaModelDir+"/c"+std::to_string(vectorNumber)+".xml";
-								//initialisation des valeurs des attributs grimm, ecore et dir (ne sont pas utilisés dans ce contexte)
-								std::string grimm = "";
-								std::string ecore = "";
-								std::string dir = "";
-								//modification de ses variables en fonction du contexte scaffold/javasmall
-								if(metaModelDir == "scaffold"){
-									grimm = "Graph.grimm";
-									ecore = "ScaffoldGraph.ecore";
-									dir = "Graph";
-								}
-								if(metaModelDir == "javasmall"){
-										grimm = "ProjectSmall.grimm";
-										ecore = "MyJava.ecore";
-										dir = "Project";
-								}
-								if(grimm == ""){
-									std::cout << "meta-model need to be scaffold or javasmall" << std::endl;
-								}
-								else{
-									//écriture dans le fichier
-									output << metaModel << std::endl;
-									output << grimm << std::endl;
-									output << ecore << std::endl;
-									output << dir << std::endl;
-			            output.close();
-			            //création du modèle à partir de ce fichier
-									Model m(outputPath);
-									
-									//lancement de la méthode générant les fichiers dot
-									std::string dotFilePath = m.generateDotFileScaffold(outputDir+"/c"+std::to_string(vectorNumber).c_str()+".dot");
-									//la suite du code est utile si on souhaite utiliser la méthode generateDotFile au lieu de generateDotFileScaffold
-									//les paramètres grimm, ecore et dir seront alors importants et un autre contexte que celui du scaffolding aussi
-									//std::string dotFilePath = m.generateDotFile(0);
-									//std::string rawfileName = dotFilePath.substr(dotFilePath.find("/"),dotFilePath.length());
-									//les fichiers étant générés dans le dossier dir il faut le déplacer vers le dossier souhaiter
-									//system(("mv "+dotFilePath+" "+outputDir).c_str());
-									
-									//le nom du fichier a était générer automatiquement et il faut le renommer
-									//std::string s0 = outputDir+"/"+rawfileName;
-									//std::string s1 = outputDir+"/c"+std::to_string(vectorNumber).c_str()+".dot";
-									
-									//rename(s0.c_str(),s1.c_str());
-									vectorNumber++;
-								}
-	          }
-	      }
-	  } else {
-	      std::cout << "Could not open the target file" << std::endl;
-	  }
-	  file.close();
+void NSGAII::exportGeneration(::Population& pop, const std::string& outputDir) {
+  mkdir(outputDir.c_str(),0777);
+  auto n = GAChromosom::getNbModels();
+  ThreadPool::instance().parallelFor(pop.size()*n, [&pop,n,&outputDir](size_t v) {
+      auto& m = static_cast<GAChromosom&>(pop.individual(v/n)).getModels()[v%n];
+      auto name = outputDir+"/c"+std::to_string(v);
+      m.writeChr(name+".chr");
+      m.generateDotFileScaffold(name+".dot");
+    });
 }
 
 NSGAII& NSGAII::operator++() {
@@ -528,3 +570,7 @@ NSGAII& NSGAII::operator++() {
 Statistics& NSGAII::extraStatistics() {
   return extraStats;
 }
+
+const Indicators& NSGAII::qualityIndicators() const {
+  return indicators;
+}
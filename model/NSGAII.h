@@ -29,6 +29,9 @@
 #include <map>
 #include "Statistics.h"
 #include "Population.h"
+#include "GenFile.h"
+#include "Metrics.h"
+#include "Indicators.h"
 
 /**
  * \class NSGAII
@@ -43,6 +46,9 @@ class NSGAII : public GASimpleGA {
  private:
   Statistics extraStats;
   unsigned int popMult;
+  GenFile::Writer genWriter;
+  bool metricsStarted;
+  Indicators indicators;
  public:
   /**
    * \brief Mask for fitness choice.
@@ -72,6 +78,29 @@ class NSGAII : public GASimpleGA {
    * Current generation.
    */
   static unsigned int gen;
+  /**
+   * Interval between full generation files (others are deltas).
+   */
+  static unsigned int keyframe;
+  /**
+   * Frequency of model export (k: every k generations and the last
+   * one, 0: last generation only, -1: no export).
+   */
+  static int exportFrequency;
+  /**
+   * Format of the performance metrics (output/metrics.csv|jsonl).
+   */
+  static GenerationMetrics::Format metricsFormat;
+  /**
+   * Relative improvement of the hypervolume below which the evolution
+   * stops (negative: indicators are not computed, 0: they are, without
+   * stopping).
+   */
+  static double convergence;
+  /**
+   * Number of generations over which the improvement is measured.
+   */
+  static unsigned int window;
   /* Identity definition for GAlib */
   GADefineIdentity("NSGAII", 288);
   /**
@@ -84,13 +113,23 @@ class NSGAII : public GASimpleGA {
    */
   virtual ~NSGAII() noexcept;
   /**
-   * Compare two matrices of score and return true if
+   * Compare a kind of distances of two objectives and return true if
    * the first one dominate the second one.
-   * \param m1 The first matrix to test.
-   * \param m2 The second one.
-   * \return true iff m1 dominates m2.
+   * \param o1 The first objectives to test.
+   * \param o2 The second one.
+   * \param k The kind of distance.
+   * \return true iff o1 dominates o2 for k.
    */
-  virtual bool dominate(MatrixPtr m1, MatrixPtr m2);
+  virtual bool dominate(const Objectives& o1, const Objectives& o2,
+			Objectives::Kind k);
+  /**
+   * Return the objectives as a point for indicators: for each kind of
+   * distance in use, the values compared by dominate() (average and
+   * min of distances when fitness is dist).
+   * \param o The objectives.
+   * \return The point.
+   */
+  static Indicators::Point point(const Objectives& o);
   /**
    * Sort population in Pareto front.
    * \return A vector of front composed by key of front's individual.
@@ -127,9 +166,18 @@ class NSGAII : public GASimpleGA {
    */
   virtual Statistics& extraStatistics();
   /**
-   * Create dot files associate to a generation
+   * Return the quality indicators of the run.
+   * \return The indicators (empty if not computed).
+   */
+  const Indicators& qualityIndicators() const;
+  /**
+   * Write the .chr and dot files of every model of a population, in
+   * parallel (c<k>.chr and c<k>.dot, k numbering models individual by
+   * individual).
+   * \param pop The population.
+   * \param outputDir The output directory.
    */
-  virtual void generateDotGen(std::string metaModelName, std::string genFile, std::string outputDir);
+  static void exportGeneration(::Population& pop, const std::string& outputDir);
   /**
    * Operator that create a new generation.
    * \return The NSGA-II algorithm with a new population.
@@ -0,0 +1,99 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Objectives.h"
+#include <algorithm>
+#include <stdexcept>
+
+/* Constructors */
+
+Objectives::Objectives(size_t models): n(0), c(0) {
+  reset(models);
+}
+
+void Objectives::reset(size_t models) {
+  if(models != n || t.empty()) {
+    n = models;
+    c = n ? n*(n-1)/2 : 0;
+    t.assign(KINDS*c, Value(0));
+  }
+  else std::fill(t.begin(), t.end(), Value(0));
+}
+
+/* Accessors */
+
+size_t Objectives::size() const {
+  return n;
+}
+
+size_t Objectives::count() const {
+  return c;
+}
+
+void Objectives::set(Kind k, size_t i, size_t j, double v) {
+  if(i == j)
+    throw std::out_of_range("Try to set distance of model "+std::to_string(i)+
+			    " to itself.");
+  t[k*c+((i < j) ? index(i,j) : index(j,i))] = v;
+}
+
+const Objectives::Value* Objectives::data(Kind k) const {
+  return t.data()+k*c;
+}
+
+/* Reductions */
+
+bool Objectives::isNull(Kind k) const {
+  auto p = data(k);
+  for(auto l = 0u; l < c; l++) {
+    if(!(p[l] > -0.0001 && p[l] < 0.0001)) return false;
+  }
+  return true;
+}
+
+double Objectives::average(Kind k) const {
+  return Matrix::triangleSum(n, data(k))/c;
+}
+
+double Objectives::min(Kind k) const {
+  return Matrix::triangleMin(n, data(k));
+}
+
+Matrix::Relation Objectives::compare(Kind k, const Objectives& o) const {
+  if(o.n != n)
+    throw std::invalid_argument("Can not compare objectives of "+std::to_string(n)+
+				" and "+std::to_string(o.n)+" models.");
+  return Matrix::triangleCompare(n, data(k), o.data(k));
+}
+
+bool Objectives::dominates(Kind k, const Objectives& o) const {
+  return compare(k, o) == Matrix::GREATER;
+}
+
+Matrix Objectives::matrix(Kind k) const {
+  Matrix ret(n);
+  for(auto i = 0u; i < n; i++) {
+    for(auto j = i+1; j < n; j++) {
+      ret.set(i, j, get(k, i, j));
+    }
+  }
+  return ret;
+}
+
+Logger& operator<<(Logger& log, const Objectives& o) {
+  for(auto k = 0; k < Objectives::KINDS; k++) {
+    log<<o.matrix(static_cast<Objectives::Kind>(k))<<"\n";
+  }
+  return log;
+}
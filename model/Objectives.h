@@ -0,0 +1,166 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file Objectives.h
+ * \brief Objectives class header.
+ * \author Florian Galinier
+ * \version 0.1
+ * \date 19/10/26
+ *
+ * Distances between the models of a chromosom.
+ *
+ */
+
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Matrix.h"
+#include "utils/Aligned.h"
+#include "utils/Logger.h"
+
+/**
+ * \class Objectives
+ * \brief Scores of a chromosom, for each kind of distance and each pair
+ * of models.
+ *
+ * Every kind of distance gives a symmetric matrix with a null diagonal.
+ * Their strict upper triangles are stored one after the other in a
+ * single buffer (kind × model pair), with the layout of Matrix, so that
+ * Matrix kernels apply to each kind.
+ *
+ * \author Florian Galinier
+ */
+class Objectives {
+ public:
+  typedef Matrix::Value Value;
+  /**
+   * \brief Kind of distance.
+   */
+  enum Kind {
+    COSINE = 0,
+    HAMMING,
+    CENTRALITY,
+    LEVENSHTEIN,
+    LEVEXTERN,
+    KINDS,
+  };
+ private:
+  size_t n;
+  size_t c;
+  std::vector<Value,AlignedAllocator<Value>> t;
+  /**
+   * Return the offset of element (i,j), i < j, in a triangle.
+   */
+  size_t index(size_t i,size_t j) const {
+    return i*(2*n-i-1)/2 + (j-i-1);
+  }
+ public:
+  /**
+   * Create null objectives.
+   * \param models The number of models.
+   */
+  Objectives(size_t models = 0);
+  /**
+   * Set all distances to 0. The buffer is kept if the number of models
+   * does not change.
+   * \param models The number of models.
+   */
+  void reset(size_t models);
+  /**
+   * Return the number of models.
+   * \return The number of models.
+   */
+  size_t size() const;
+  /**
+   * Return the number of model pairs (elements of a triangle).
+   * \return The number of pairs.
+   */
+  size_t count() const;
+  /**
+   * Return the distance of a pair of models.
+   * \param k The kind of distance.
+   * \param i The first model.
+   * \param j The second model.
+   * \return The distance (0 if i == j).
+   */
+  Value get(Kind k, size_t i, size_t j) const {
+    const Value* p = t.data()+k*c;
+    return (i < j) ? p[index(i,j)] : (j < i) ? p[index(j,i)] : Value(0);
+  }
+  /**
+   * Change the distance of a pair of models.
+   * \param k The kind of distance.
+   * \param i The first model.
+   * \param j The second model.
+   * \param v The distance.
+   * \throw std::out_of_range if i == j.
+   */
+  void set(Kind k, size_t i, size_t j, double v);
+  /**
+   * Return the triangle of a kind of distance.
+   * \param k The kind of distance.
+   * \return The count() distances of k.
+   */
+  const Value* data(Kind k) const;
+  /**
+   * Return true if all distances of a kind are null.
+   * \param k The kind of distance.
+   * \return true iff the distances of k are null.
+   */
+  bool isNull(Kind k) const;
+  /**
+   * Return the average distance of a kind.
+   * \param k The kind of distance.
+   * \return The average distance.
+   */
+  double average(Kind k) const;
+  /**
+   * Return the minimum distance of a kind.
+   * \param k The kind of distance.
+   * \return The minimum distance.
+   */
+  double min(Kind k) const;
+  /**
+   * Compare the distances of a kind with those of other objectives.
+   * \param k The kind of distance.
+   * \param o The other objectives.
+   * \return The relation of current distances to those of o.
+   * \throw std::invalid_argument if numbers of models differ.
+   */
+  Matrix::Relation compare(Kind k, const Objectives& o) const;
+  /**
+   * Return true if all distances of a kind are greater or equal to
+   * those of o, and one is greater.
+   * \param k The kind of distance.
+   * \param o The other objectives.
+   * \return true iff current distances of k dominate those of o.
+   */
+  bool dominates(Kind k, const Objectives& o) const;
+  /**
+   * Return the distances of a kind as a matrix.
+   * \param k The kind of distance.
+   * \return A copy of the distances.
+   */
+  Matrix matrix(Kind k) const;
+};
+/**
+ * Specialization of Logger operator<< for Objectives: the matrices of
+ * every kind.
+ * \param log The logger where to write
+ * \param o The objectives to write
+ * \return The used logger
+ */
+Logger& operator<<(Logger& log, const Objectives& o);
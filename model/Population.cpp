@@ -14,40 +14,107 @@
 
 #include "Population.h"
 #include "utils/Directory.h"
+#include "utils/Probes.h"
+#include "utils/ThreadPool.h"
 #include <dirent.h>
 #include <limits>
+#include <algorithm>
+#include <iterator>
+#include <fstream>
+#include <sstream>
+#include <cctype>
+#include <set>
+#include <stdexcept>
 
 Population::Population() {}
 
-Population::Population(std::string dirPath): Population() {
-  Directory d(dirPath);
-  
+Population::Population(std::string dirPath): Population(loadModels(dirPath)) {}
 
-  int nbt = d.getNbFiles(".chr");
+Population::Population(const std::vector<Model>& models): Population() {
+  int nbt = models.size();
 
   //doesnt use all model if (nbt % Chromosom::getNbModels() != 0)
   int nbFilesUsed = nbt - (nbt % Chromosom::getNbModels());
   
   //force use of all model
-  /*if(d.getNbFiles(".chr") % Chromosom::getNbModels() != 0) {
+  /*if(nbt % Chromosom::getNbModels() != 0) {
     std::cerr<<"Error: Number of models must be a multiple of "<<Chromosom::getNbModels()<<"."<<std::endl;
     exit(1);
   }*/
   /* TODO: Throw an exception instead of exit. */
-  
-  auto t = d.getFiles(".chr");
-  
-  
+
   int i=0;
   while(i<nbFilesUsed){
-    std::vector<std::string> tmp;
-    for(size_t j=0;j<Chromosom::getNbModels();j++) {
-      tmp.push_back(dirPath+"/"+(*t)[i+j]);
-    }
-    this->newChromosom(tmp);
+    std::vector<Model> tmp(models.begin()+i,
+			   models.begin()+i+Chromosom::getNbModels());
+    GAChromosom c;
+    c.setModels(std::move(tmp));
+    this->add(c);
     i += Chromosom::getNbModels();
   }
-  
+}
+
+std::vector<Model> Population::loadModels(const std::string& dirPath) {
+  auto t = manifest(dirPath);
+  // Models are parsed in parallel, XCSP files being parsed once
+  std::vector<Model> models(t.size());
+  ThreadPool::instance().parallelFor(t.size(), [&](size_t i) {
+      PROBE_TIMER("model load");
+      models[i] = Model(dirPath+"/"+t[i]);
+    });
+  return models;
+}
+
+std::vector<std::string> Population::manifest(const std::string& dirPath) {
+  Directory d(dirPath);
+  auto files = *d.getFiles(".chr");
+  // Natural order: digit runs are compared as numbers
+  std::sort(files.begin(), files.end(), [](const std::string& a, const std::string& b) {
+      size_t i = 0, j = 0;
+      while(i < a.size() && j < b.size()) {
+	if(isdigit(a[i]) && isdigit(b[j])) {
+	  auto ei = a.find_first_not_of("0123456789", i);
+	  auto ej = b.find_first_not_of("0123456789", j);
+	  ei = (ei == std::string::npos) ? a.size() : ei;
+	  ej = (ej == std::string::npos) ? b.size() : ej;
+	  auto na = a.substr(i, ei-i), nb = b.substr(j, ej-j);
+	  na.erase(0, std::min(na.find_first_not_of('0'), na.size()));
+	  nb.erase(0, std::min(nb.find_first_not_of('0'), nb.size()));
+	  if(na.size() != nb.size()) return na.size() < nb.size();
+	  if(na != nb) return na < nb;
+	  i = ei;
+	  j = ej;
+	}
+	else {
+	  if(a[i] != b[j]) return a[i] < b[j];
+	  i++;
+	  j++;
+	}
+      }
+      if(a.size()-i != b.size()-j) return a.size()-i < b.size()-j;
+      return a < b;
+    });
+
+  std::ifstream in(dirPath+"/manifest");
+  if(!in)
+    return files;
+  // Files of the manifest come first, in its order, then the files
+  // added since it was written
+  std::set<std::string> present(files.begin(), files.end()), listed;
+  std::vector<std::string> ret;
+  std::string line;
+  while(std::getline(in, line)) {
+    std::istringstream iss(line);
+    std::string f;
+    if(!(iss >> f) || f[0] == '#' || !listed.insert(f).second) continue;
+    if(!present.count(f))
+      throw std::runtime_error("File "+f+" of "+dirPath+"/manifest does not exist.");
+    ret.push_back(f);
+  }
+  for(auto& f : files) {
+    if(!listed.count(f)) ret.push_back(f);
+  }
+  return ret;
 }
 
 inline void Population::newChromosom(const std::vector<std::string>& files) {
@@ -70,17 +137,14 @@ MatrixPtr Population::popEvaluate(GABoolean flag) {
       if(GAChromosom::method & GAChromosom::Method::COSINE) {
 				auto dist = Model::evaluate(chr.getModels()[0],chr2.getModels()[0]);
 				score->set(i,j,dist);
-				score->set(j,i,dist);
       }
       else {
 				auto dist = Model::evaluateExtern(chr.getModels()[0],chr2.getModels()[0]);
 				if(GAChromosom::method & GAChromosom::Method::CENTRALITY) {
 					score->set(i,j,std::get<1>(dist));
-					score->set(j,i,std::get<1>(dist));
 				}
 				else {
 					score->set(i,j,std::get<0>(dist));
-					score->set(j,i,std::get<0>(dist));
 				}
       }
     }
@@ -95,8 +159,9 @@ GAChromosom& Population::best(size_t r,size_t c) {
   auto score = std::numeric_limits<double>::min(); 
   auto ind = 0;
   for(auto i=0;i<size();i++) {
-    auto res = dynamic_cast<GAChromosom&>(individual(i)).score();
-    auto sc = (*res[0])[r][c]+(*res[1])[r][c]+(*res[2])[r][c];
+    auto& res = dynamic_cast<GAChromosom&>(individual(i)).score();
+    auto sc = res.get(Objectives::COSINE,r,c)+res.get(Objectives::HAMMING,r,c)+
+      res.get(Objectives::CENTRALITY,r,c);
     if (sc > score) {
       score = sc;
       ind = i;
@@ -109,8 +174,9 @@ GAChromosom& Population::worst(size_t r,size_t c) {
   auto score = std::numeric_limits<double>::max(); 
   auto ind = 0;
   for(auto i=0;i<size();i++) {
-    auto res = dynamic_cast<GAChromosom&>(individual(i)).score();
-    auto sc = (*res[0])[r][c]+(*res[1])[r][c]+(*res[2])[r][c];
+    auto& res = dynamic_cast<GAChromosom&>(individual(i)).score();
+    auto sc = res.get(Objectives::COSINE,r,c)+res.get(Objectives::HAMMING,r,c)+
+      res.get(Objectives::CENTRALITY,r,c);
     if (sc < score) {
       score = sc;
       ind = i;
@@ -124,10 +190,7 @@ Logger& operator<<(Logger& log, const Population& p) {
     auto& ind = static_cast<GAChromosom&>(p.individual(i));
     log<<"--------------\n";
     log<<ind<<"\n";
-    auto res = ind.score();
-    log<<*res[0]<<"\n";
-    log<<*res[1]<<"\n";
-    log<<*res[2]<<"\n";
+    log<<ind.score();
   }
   return log;
 }
@@ -43,10 +43,33 @@ class Population : public GAPopulation {
    */
   Population();
   /**
-   * Create a population from files given in directory.
+   * Create a population from files given in directory. Models are
+   * read in parallel and grouped in chromosoms in manifest order.
    * \param dirPath The directory where the models files are.
    */
   Population(std::string dirPath);
+  /**
+   * Create a population from loaded models, grouped in chromosoms of
+   * Chromosom::getNbModels() models (remaining models are not used).
+   * Models share their genes and artifacts with the given ones.
+   * \param models The models.
+   */
+  Population(const std::vector<Model>& models);
+  /**
+   * Read the models of a directory in parallel, in manifest order.
+   * \param dirPath The directory where the models files are.
+   * \return The models.
+   */
+  static std::vector<Model> loadModels(const std::string& dirPath);
+  /**
+   * Return the .chr files of a directory, in the order given by its
+   * manifest file if any, then in natural order (c2 before c10) for
+   * files the manifest does not list.
+   * \param dirPath The directory where the models files are.
+   * \return The model file names.
+   * \throw std::runtime_error if the manifest lists a missing file.
+   */
+  static std::vector<std::string> manifest(const std::string& dirPath);
   /**
    * Evaluate all individuals of population
    * \param Force or not the evaluation
@@ -0,0 +1,595 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Xcsp.h"
+#include "utils/Random.h"
+#include "XcspReader.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <limits>
+#include <cstdlib>
+
+/* Functional expressions of predicates */
+
+/**
+ * \struct XcspExpression
+ * \brief A node of a functional expression (e.g. lt(v1,add(v2,1))).
+ */
+struct XcspExpression {
+  enum Op {
+    CONST, PARAM,
+    NEG, ABS, ADD, SUB, MUL, DIV, MOD, POW, MIN, MAX,
+    EQ, NE, GE, GT, LE, LT,
+    NOT, AND, OR, XOR, IFF, IF
+  } op;
+  long value;
+  std::vector<XcspExpression> args;
+
+  long eval(const std::vector<long>& p) const {
+    switch(op) {
+    case CONST: return value;
+    case PARAM: return p[value];
+    case NEG: return -args[0].eval(p);
+    case ABS: return std::labs(args[0].eval(p));
+    case ADD: return args[0].eval(p) + args[1].eval(p);
+    case SUB: return args[0].eval(p) - args[1].eval(p);
+    case MUL: return args[0].eval(p) * args[1].eval(p);
+    case DIV: {
+      auto d = args[1].eval(p);
+      return d ? args[0].eval(p) / d : 0;
+    }
+    case MOD: {
+      auto d = args[1].eval(p);
+      return d ? args[0].eval(p) % d : 0;
+    }
+    case POW: {
+      long r = 1, b = args[0].eval(p), e = args[1].eval(p);
+      for(; e > 0; e--) r *= b;
+      return r;
+    }
+    case MIN: return std::min(args[0].eval(p), args[1].eval(p));
+    case MAX: return std::max(args[0].eval(p), args[1].eval(p));
+    case EQ: return args[0].eval(p) == args[1].eval(p);
+    case NE: return args[0].eval(p) != args[1].eval(p);
+    case GE: return args[0].eval(p) >= args[1].eval(p);
+    case GT: return args[0].eval(p) > args[1].eval(p);
+    case LE: return args[0].eval(p) <= args[1].eval(p);
+    case LT: return args[0].eval(p) < args[1].eval(p);
+    case NOT: return !args[0].eval(p);
+    case AND: return args[0].eval(p) && args[1].eval(p);
+    case OR: return args[0].eval(p) || args[1].eval(p);
+    case XOR: return !args[0].eval(p) != !args[1].eval(p);
+    case IFF: return !args[0].eval(p) == !args[1].eval(p);
+    case IF: return args[0].eval(p) ? args[1].eval(p) : args[2].eval(p);
+    }
+    return 0;
+  }
+};
+
+namespace {
+  /* Counters of load */
+  std::atomic<size_t> loadHits(0), loadFiles(0), loadParsed(0),
+    loadDomainsNb(0), loadVariables(0);
+  /* Time in microseconds */
+  std::atomic<long long> loadParseTime(0);
+
+  /* Recursive descent parser for functional expressions */
+  class ExpressionParser {
+    const std::string& s;
+    const std::vector<std::string>& formals;
+    size_t pos;
+
+    void skip() {
+      while(pos < s.size() && isspace(static_cast<unsigned char>(s[pos])))
+	pos++;
+    }
+
+    std::string identifier() {
+      skip();
+      auto start = pos;
+      while(pos < s.size() &&
+	    (isalnum(static_cast<unsigned char>(s[pos])) || s[pos] == '_' ||
+	     s[pos] == '-'))
+	pos++;
+      if(start == pos)
+	throw std::invalid_argument("Unexpected character in expression: "+s);
+      return s.substr(start, pos-start);
+    }
+
+  public:
+    ExpressionParser(const std::string& s,
+		     const std::vector<std::string>& formals):
+      s(s), formals(formals), pos(0) {}
+
+    XcspExpression parse() {
+      static const std::map<std::string,std::pair<XcspExpression::Op,size_t>>
+	ops = {
+	{"neg",{XcspExpression::NEG,1}}, {"abs",{XcspExpression::ABS,1}},
+	{"add",{XcspExpression::ADD,2}}, {"sub",{XcspExpression::SUB,2}},
+	{"mul",{XcspExpression::MUL,2}}, {"div",{XcspExpression::DIV,2}},
+	{"mod",{XcspExpression::MOD,2}}, {"pow",{XcspExpression::POW,2}},
+	{"min",{XcspExpression::MIN,2}}, {"max",{XcspExpression::MAX,2}},
+	{"eq",{XcspExpression::EQ,2}}, {"ne",{XcspExpression::NE,2}},
+	{"ge",{XcspExpression::GE,2}}, {"gt",{XcspExpression::GT,2}},
+	{"le",{XcspExpression::LE,2}}, {"lt",{XcspExpression::LT,2}},
+	{"not",{XcspExpression::NOT,1}}, {"and",{XcspExpression::AND,2}},
+	{"or",{XcspExpression::OR,2}}, {"xor",{XcspExpression::XOR,2}},
+	{"iff",{XcspExpression::IFF,2}}, {"if",{XcspExpression::IF,3}},
+      };
+      XcspExpression e;
+      auto id = identifier();
+      skip();
+      if(pos < s.size() && s[pos] == '(') {
+	auto op = ops.find(id);
+	if(op == ops.end())
+	  throw std::invalid_argument("Unsupported operator: "+id);
+	e.op = op->second.first;
+	e.value = 0;
+	pos++;
+	do {
+	  e.args.push_back(parse());
+	  skip();
+	} while(pos < s.size() && s[pos++] == ',');
+	if(s[pos-1] != ')' || e.args.size() != op->second.second)
+	  throw std::invalid_argument("Malformed expression: "+s);
+	return e;
+      }
+      auto f = std::find(formals.begin(), formals.end(), id);
+      if(f != formals.end()) {
+	e.op = XcspExpression::PARAM;
+	e.value = f - formals.begin();
+      }
+      else {
+	e.op = XcspExpression::CONST;
+	e.value = std::stol(id);
+      }
+      return e;
+    }
+  };
+
+  std::vector<std::string> tokens(const std::string& s) {
+    std::istringstream iss(s);
+    std::vector<std::string> ret;
+    std::string t;
+    while(iss >> t) ret.push_back(t);
+    return ret;
+  }
+
+  bool isInteger(const std::string& s) {
+    if(s.empty()) return false;
+    auto start = (s[0] == '-' || s[0] == '+') ? 1u : 0u;
+    if(start == s.size()) return false;
+    return std::all_of(s.begin()+start, s.end(),
+		       [](char c) { return isdigit(static_cast<unsigned char>(c)); });
+  }
+
+  /* Split "[ a b ] [ c d ]" in lists of tokens */
+  std::vector<std::vector<std::string>> lists(const std::string& s) {
+    std::vector<std::vector<std::string>> ret;
+    for(auto& t : tokens(s)) {
+      if(t == "[") ret.emplace_back();
+      else if(t != "]" && !ret.empty()) ret.back().push_back(t);
+    }
+    return ret;
+  }
+
+  struct Predicate {
+    std::vector<std::string> formals;
+    std::shared_ptr<const XcspExpression> expression;
+  };
+}
+
+/* Constructors */
+
+Xcsp::Xcsp(): supported(true), valid(true) {}
+
+Xcsp::Xcsp(const std::string& path): Xcsp() {
+  std::ifstream in(path, std::ios_base::binary);
+  if(!in) {
+    supported = false;
+    valid = false;
+    return;
+  }
+  read(in);
+}
+
+Xcsp::Xcsp(std::istream& in): Xcsp() {
+  read(in);
+}
+
+void Xcsp::read(std::istream& in) {
+  // Elements are added to the network as they are read
+  struct Loader : XcspReader::Handler {
+    Xcsp& x;
+    std::unordered_map<std::string,IntervalVector<int>> doms;
+    std::unordered_map<std::string,Predicate> preds;
+    Loader(Xcsp& x): x(x) {}
+
+    void domain(const std::string& name, const std::string& values) {
+      IntervalVector<int> iv;
+      for(auto& t : tokens(values)) {
+	iv.add(t);
+      }
+      doms.emplace(name, iv);
+    }
+
+    void variable(const std::string& name, const std::string& domain) {
+      auto d = doms.find(domain);
+      x.index.emplace(name, x.variables.size());
+      x.variables.push_back(name);
+      if(d != doms.end())
+	x.domains.push_back(d->second);
+      else {
+	x.domains.emplace_back();
+	x.supported = false;
+	x.valid = false;
+      }
+      x.varConstraints.emplace_back();
+    }
+
+    void predicate(const std::string& name, const std::string& parameters,
+		   const std::string& expression) {
+      Predicate pred;
+      auto params = tokens(parameters);
+      for(auto i = 1u; i < params.size(); i += 2) {
+	pred.formals.push_back(params[i]);
+      }
+      try {
+	pred.expression = std::make_shared<XcspExpression>
+	  (ExpressionParser(expression, pred.formals).parse());
+      }
+      catch(std::exception&) {
+	pred.expression = nullptr;
+      }
+      preds.emplace(name, pred);
+    }
+
+    void constraint(const std::string& name, const std::string& scope,
+		    const std::string& ref, const std::string& params) {
+      Constraint cons;
+      auto scopeOk = true;
+      for(auto& v : tokens(scope)) {
+	auto i = x.index.find(v);
+	if(i == x.index.end()) scopeOk = false;
+	else cons.scope.push_back(i->second);
+      }
+      auto pred = preds.find(ref);
+      auto ok = scopeOk;
+      if(pred != preds.end()) {
+	cons.kind = Constraint::PREDICATE;
+	cons.expression = pred->second.expression;
+	ok &= (cons.expression != nullptr);
+	for(auto& t : tokens(params)) {
+	  if(isInteger(t))
+	    cons.arguments.push_back({false, std::stol(t)});
+	  else {
+	    auto i = x.index.find(t);
+	    ok &= (i != x.index.end());
+	    if(i != x.index.end())
+	      cons.arguments.push_back({true, static_cast<long>(i->second)});
+	  }
+	}
+	ok &= (cons.arguments.size() == pred->second.formals.size());
+      }
+      else if(ref == "global:globalCardinality" ||
+	      ref == "global:globalcardinality") {
+	cons.kind = Constraint::CARDINALITY;
+	auto l = lists(params);
+	ok &= (l.size() == 4 && l[1].size() == l[2].size() &&
+	       l[1].size() == l[3].size());
+	if(ok) {
+	  // Counted variables are taken from scope
+	  for(auto k = 0u; k < l[1].size(); k++) {
+	    cons.values.push_back(std::stoi(l[1][k]));
+	    cons.lbounds.push_back(std::stoi(l[2][k]));
+	    cons.ubounds.push_back(std::stoi(l[3][k]));
+	  }
+	}
+      }
+      else ok = false;
+
+      if(!ok) {
+	x.supported = false;
+	return;
+      }
+      for(auto v : cons.scope) {
+	x.varConstraints[v].push_back(x.constraints.size());
+      }
+      x.constraints.push_back(std::move(cons));
+    }
+  } loader(*this);
+
+  XcspReader reader(in, loader);
+  if(!reader.read()) {
+    supported = false;
+    valid = false;
+  }
+  loadDomainsNb += loader.doms.size();
+  computeCutPoints();
+}
+
+namespace {
+  long long elapsed(std::chrono::steady_clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::microseconds>
+      (std::chrono::steady_clock::now()-t).count();
+  }
+
+  /* Canonical path of a file, the path itself if it can not be
+     resolved */
+  std::string canonical(const std::string& path) {
+    auto real = realpath(path.c_str(), nullptr);
+    if(!real) return path;
+    std::string ret(real);
+    free(real);
+    return ret;
+  }
+
+  /* Network of a file, parsed by the first thread asking for it */
+  struct Entry {
+    std::once_flag once;
+    std::shared_ptr<const Xcsp> network;
+  };
+}
+
+std::shared_ptr<const Xcsp> Xcsp::load(const std::string& path) {
+  static std::mutex lock;
+  static std::unordered_map<std::string,std::shared_ptr<Entry>> byPath;
+  static std::unordered_map<std::string,std::shared_ptr<Entry>> byFile;
+  std::shared_ptr<Entry> e;
+  auto hit = true;
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    auto c = byPath.find(path);
+    if(c != byPath.end()) e = c->second;
+  }
+  if(!e) {
+    // Paths of the same file (relative, through links) share its network
+    auto file = canonical(path);
+    loadFiles++;
+    std::lock_guard<std::mutex> guard(lock);
+    auto& slot = byPath[path];
+    if(!slot) {
+      auto& entry = byFile[file];
+      if(!entry) {
+	entry = std::make_shared<Entry>();
+	hit = false;
+      }
+      slot = entry;
+    }
+    e = slot;
+  }
+  if(hit) loadHits++;
+  // The file is read once, while it is parsed
+  std::call_once(e->once, [&e,&path]() {
+      auto t = std::chrono::steady_clock::now();
+      e->network = std::make_shared<const Xcsp>(path);
+      loadParsed++;
+      loadVariables += e->network->size();
+      loadParseTime += elapsed(t);
+    });
+  return e->network;
+}
+
+Xcsp::LoadCounters Xcsp::loadCounters() {
+  return {loadFiles, loadParsed, loadDomainsNb, loadVariables,
+      loadParseTime/1000.0};
+}
+
+size_t Xcsp::cacheHits() {
+  return loadHits;
+}
+
+void Xcsp::computeCutPoints() {
+  // straddle[p] > 0 iff a scope includes variables p-1 and p
+  std::vector<int> straddle(variables.size()+1, 0);
+  for(auto& c : constraints) {
+    if(c.scope.empty()) continue;
+    auto bounds = std::minmax_element(c.scope.begin(), c.scope.end());
+    straddle[*bounds.first+1]++;
+    straddle[*bounds.second+1]--;
+  }
+  cuts.clear();
+  auto open = 0;
+  for(auto p = 1u; p < variables.size(); p++) {
+    open += straddle[p];
+    if(!open) cuts.push_back(p);
+  }
+}
+
+/* Accessors */
+
+bool Xcsp::isSupported() const {
+  return supported;
+}
+
+bool Xcsp::isValid() const {
+  return valid;
+}
+
+size_t Xcsp::size() const {
+  return variables.size();
+}
+
+const std::vector<std::string>& Xcsp::getVariables() const {
+  return variables;
+}
+
+const std::vector<IntervalVector<int>>& Xcsp::getDomains() const {
+  return domains;
+}
+
+const std::vector<Xcsp::Constraint>& Xcsp::getConstraints() const {
+  return constraints;
+}
+
+const std::vector<size_t>& Xcsp::constraintsOf(size_t v) const {
+  return varConstraints.at(v);
+}
+
+const std::vector<size_t>& Xcsp::cutPoints() const {
+  return cuts;
+}
+
+/* Checking */
+
+bool Xcsp::satisfied(size_t c, const Genes& g) const {
+  auto& cons = constraints[c];
+  if(cons.kind == Constraint::PREDICATE) {
+    std::vector<long> p;
+    p.reserve(cons.arguments.size());
+    for(auto& a : cons.arguments) {
+      p.push_back(a.variable ? g[a.value] : a.value);
+    }
+    return cons.expression->eval(p) != 0;
+  }
+  for(auto k = 0u; k < cons.values.size(); k++) {
+    auto nb = std::count_if(cons.scope.begin(), cons.scope.end(),
+			    [&](size_t v) { return g[v] == cons.values[k]; });
+    if(nb < cons.lbounds[k] || nb > cons.ubounds[k])
+      return false;
+  }
+  return true;
+}
+
+bool Xcsp::check(const Genes& g) const {
+  if(g.size() != variables.size()) return false;
+  for(auto v = 0u; v < g.size(); v++) {
+    if(!domains[v].include(g[v])) return false;
+  }
+  for(auto c = 0u; c < constraints.size(); c++) {
+    if(!satisfied(c, g)) return false;
+  }
+  return true;
+}
+
+size_t Xcsp::conflicts(size_t v, const Genes& g) const {
+  size_t nb = domains[v].include(g[v]) ? 0 : 1;
+  for(auto c : varConstraints[v]) {
+    if(!satisfied(c, g)) nb++;
+  }
+  return nb;
+}
+
+bool Xcsp::consistent(size_t v, int val, Genes& g) const {
+  auto old = g[v];
+  g[v] = val;
+  auto ok = true;
+  for(auto c : varConstraints[v]) {
+    if(!satisfied(c, g)) {
+      ok = false;
+      break;
+    }
+  }
+  g[v] = old;
+  return ok;
+}
+
+/* Repair */
+
+bool Xcsp::repair(Genes& g, size_t maxSteps) const {
+  if(g.size() != variables.size()) return false;
+  // Values out of their domain are first redrawn
+  for(auto v = 0u; v < g.size(); v++) {
+    auto nb = domains[v].count();
+    if(!nb) return false;
+    if(!domains[v].include(g[v]))
+      g[v] = domains[v].at(Random::randomInt(0, nb-1));
+  }
+
+  // Min-conflicts local search on violated constraints
+  const size_t maxCandidates = 64;
+  std::vector<size_t> violated;
+  for(auto step = 0u; step < maxSteps; step++) {
+    violated.clear();
+    for(auto c = 0u; c < constraints.size(); c++) {
+      if(!satisfied(c, g)) violated.push_back(c);
+    }
+    if(violated.empty()) return true;
+
+    auto& scope = constraints[violated[Random::randomInt(0, violated.size()-1)]].scope;
+    if(scope.empty()) return false;
+    // Find the change of a scope variable that minimizes conflicts
+    auto bestVar = scope[0];
+    auto bestVal = g[bestVar];
+    long bestDelta = std::numeric_limits<long>::max();
+    auto ties = 0;
+    for(auto v : scope) {
+      auto old = g[v];
+      long before = conflicts(v, g);
+      auto nb = domains[v].count();
+      auto candidates = std::min(nb, maxCandidates);
+      for(auto k = 0u; k < candidates; k++) {
+	auto val = (nb <= maxCandidates) ? domains[v].at(k) :
+	  domains[v].at(Random::randomInt(0, nb-1));
+	if(val == old) continue;
+	g[v] = val;
+	long delta = static_cast<long>(conflicts(v, g)) - before;
+	if(delta < bestDelta) {
+	  bestDelta = delta;
+	  bestVar = v;
+	  bestVal = val;
+	  ties = 1;
+	}
+	else if(delta == bestDelta && Random::randomInt(0, ties++) == 0) {
+	  bestVar = v;
+	  bestVal = val;
+	}
+      }
+      g[v] = old;
+    }
+    // Random walk when stuck in a local minimum
+    if(bestDelta >= 0 && Random::randomFloat(0.0, 1.0) < 0.1) {
+      bestVar = scope[Random::randomInt(0, scope.size()-1)];
+      auto nb = domains[bestVar].count();
+      bestVal = domains[bestVar].at(Random::randomInt(0, nb-1));
+    }
+    g[bestVar] = bestVal;
+  }
+  return check(g);
+}
+
+/* Mutation */
+
+bool Xcsp::mutate(size_t v, Genes& g) const {
+  const size_t maxEnumerated = 256;
+  auto old = g[v];
+  auto nb = domains[v].count();
+  if(nb <= maxEnumerated) {
+    // Small domains are filtered, then a value is drawn uniformly
+    std::vector<int> values;
+    values.reserve(nb);
+    for(auto k = 0u; k < nb; k++) {
+      auto val = domains[v].at(k);
+      if(val != old && consistent(v, val, g)) values.push_back(val);
+    }
+    if(values.empty()) return false;
+    g[v] = values[Random::randomInt(0, values.size()-1)];
+    return true;
+  }
+  // Large domains are sampled until a consistent value is found
+  for(auto k = 0u; k < maxEnumerated; k++) {
+    auto val = domains[v].at(Random::randomInt(0, nb-1));
+    if(val != old && consistent(v, val, g)) {
+      g[v] = val;
+      return true;
+    }
+  }
+  return false;
+}
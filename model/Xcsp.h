@@ -0,0 +1,248 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file Xcsp.h
+ * \brief Xcsp class header.
+ * \author Florian Galinier
+ * \version 0.1
+ * \date 19/10/26
+ *
+ * In-memory constraint network of an XCSP 2 instance, used to check
+ * and repair gene vectors without launching the external solver.
+ *
+ */
+
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <istream>
+#include "utils/IntervalVector.h"
+
+/**
+ * A gene vector (see Model.h).
+ */
+typedef std::vector<int> Genes;
+
+struct XcspExpression;
+
+/**
+ * \class Xcsp
+ * \brief Constraint network of an XCSP instance.
+ *
+ * Variables are indexed in document order, which is the order of
+ * genes in a Model. Supported constraints are predicates with a
+ * functional expression and global:globalCardinality. An instance
+ * containing any other constraint is flagged as not supported, and
+ * validity must then be checked by the external solver.
+ *
+ * \author Florian Galinier
+ */
+class Xcsp {
+ public:
+  /**
+   * \brief An argument of a predicate constraint: a variable or a
+   * constant.
+   */
+  struct Argument {
+    bool variable;
+    long value;
+  };
+  /**
+   * \brief A constraint of the network.
+   */
+  struct Constraint {
+    enum Kind { PREDICATE, CARDINALITY } kind;
+    /**
+     * Indexes of variables in scope.
+     */
+    std::vector<size_t> scope;
+    /**
+     * Predicate expression and effective arguments (PREDICATE).
+     */
+    std::shared_ptr<const XcspExpression> expression;
+    std::vector<Argument> arguments;
+    /**
+     * Counted values and their bounds (CARDINALITY).
+     */
+    std::vector<int> values;
+    std::vector<int> lbounds;
+    std::vector<int> ubounds;
+  };
+ private:
+  std::vector<std::string> variables;
+  std::unordered_map<std::string,size_t> index;
+  std::vector<IntervalVector<int>> domains;
+  std::vector<Constraint> constraints;
+  std::vector<std::vector<size_t>> varConstraints;
+  std::vector<size_t> cuts;
+  bool supported;
+  bool valid;
+  /**
+   * Compute cut points from constraint scopes.
+   */
+  void computeCutPoints();
+  /**
+   * Return the number of violated constraints touching variable v.
+   * \param v The variable index.
+   * \param g The values of variables.
+   * \return The number of violated constraints.
+   */
+  size_t conflicts(size_t v, const Genes& g) const;
+  /**
+   * Read the network from a stream (see XcspReader).
+   * \param in The stream of the instance.
+   */
+  void read(std::istream& in);
+  /**
+   * Return true if value val of variable v satisfies every constraint
+   * touching v.
+   * \param v The variable index.
+   * \param val The tested value.
+   * \param g The values of variables (g[v] is restored on return).
+   * \return true iff val is consistent with other values of g.
+   */
+  bool consistent(size_t v, int val, Genes& g) const;
+ public:
+  /**
+   * Create an empty network.
+   */
+  Xcsp();
+  /**
+   * Load the network from an XCSP file.
+   * \param path The XCSP file path.
+   */
+  Xcsp(const std::string& path);
+  /**
+   * Load the network from a stream.
+   * \param in The stream of the instance.
+   */
+  Xcsp(std::istream& in);
+  /**
+   * Return the network of an XCSP file. A file is read and parsed
+   * once, in a single pass, and its network shared by all callers,
+   * whatever the path used to reach it (relative, through links).
+   * \param path The XCSP file path.
+   * \return The shared network.
+   */
+  static std::shared_ptr<const Xcsp> load(const std::string& path);
+  /**
+   * \brief Counters of load(), times in milliseconds summed over
+   * threads.
+   */
+  struct LoadCounters {
+    /**
+     * Number of distinct paths requested, and of distinct files
+     * parsed.
+     */
+    size_t files;
+    size_t parsed;
+    /**
+     * Number of domains and variables of parsed files.
+     */
+    size_t domains;
+    size_t variables;
+    /**
+     * Time spent reading and parsing files.
+     */
+    double parseTime;
+  };
+  /**
+   * Return the counters of load() since the start of the process.
+   * \return The counters.
+   */
+  static LoadCounters loadCounters();
+  /**
+   * Return the number of load calls served by already loaded networks.
+   * \return The number of cache hits.
+   */
+  static size_t cacheHits();
+  /**
+   * Return true if every constraint of the instance can be checked.
+   * \return true iff the network is supported.
+   */
+  bool isSupported() const;
+  /**
+   * Return true if the whole instance was read: the file could be
+   * opened, the document is well formed (not truncated) and every
+   * variable has a known domain.
+   * \return true iff the instance is valid.
+   */
+  bool isValid() const;
+  /**
+   * Return the number of variables.
+   * \return The number of variables.
+   */
+  size_t size() const;
+  /**
+   * Return the variable names (in document order).
+   * \return The variable names.
+   */
+  const std::vector<std::string>& getVariables() const;
+  /**
+   * Return the domains of variables (in document order).
+   * \return The domains of variables.
+   */
+  const std::vector<IntervalVector<int>>& getDomains() const;
+  /**
+   * Return the constraints of the network.
+   * \return The constraints.
+   */
+  const std::vector<Constraint>& getConstraints() const;
+  /**
+   * Return the constraints touching a variable.
+   * \param v The variable index.
+   * \return Indexes of constraints whose scope includes v.
+   */
+  const std::vector<size_t>& constraintsOf(size_t v) const;
+  /**
+   * Return the positions p (0 < p < size()) where genes can be cut
+   * without splitting the scope of a constraint.
+   * \return The sorted cut points.
+   */
+  const std::vector<size_t>& cutPoints() const;
+  /**
+   * Check a single constraint.
+   * \param c The constraint index.
+   * \param g The values of variables.
+   * \return true iff the constraint is satisfied.
+   */
+  bool satisfied(size_t c, const Genes& g) const;
+  /**
+   * Check every domain and every constraint.
+   * \param g The values of variables.
+   * \return true iff g is a solution of the network.
+   */
+  bool check(const Genes& g) const;
+  /**
+   * Repair g by local search (min-conflicts): values of variables in
+   * violated constraints are changed until g is a solution or until
+   * maxSteps changes were made.
+   * \param g The values of variables to repair.
+   * \param maxSteps The maximum number of changes.
+   * \return true iff g is a solution.
+   */
+  bool repair(Genes& g, size_t maxSteps = 1000) const;
+  /**
+   * Change the value of variable v to another value of its domain
+   * consistent with the constraints touching v. If g is a solution,
+   * it remains a solution.
+   * \param v The variable index.
+   * \param g The values of variables.
+   * \return true iff a new value was found.
+   */
+  bool mutate(size_t v, Genes& g) const;
+};
@@ -0,0 +1,252 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "XcspReader.h"
+#include <cctype>
+#include <cstring>
+
+namespace {
+  const size_t bufferSize = 1 << 16;
+
+  /* Replace predefined entities */
+  void decode(std::string& s) {
+    auto amp = s.find('&');
+    if(amp == std::string::npos) return;
+    static const std::pair<const char*,char> entities[] = {
+      {"&lt;",'<'}, {"&gt;",'>'}, {"&amp;",'&'}, {"&quot;",'"'}, {"&apos;",'\''},
+    };
+    std::string ret(s, 0, amp);
+    for(auto i = amp; i < s.size();) {
+      auto found = false;
+      if(s[i] == '&') {
+	for(auto& e : entities) {
+	  auto n = strlen(e.first);
+	  if(!s.compare(i, n, e.first)) {
+	    ret += e.second;
+	    i += n;
+	    found = true;
+	    break;
+	  }
+	}
+      }
+      if(!found) ret += s[i++];
+    }
+    s = std::move(ret);
+  }
+
+  const std::string* attribute(const std::vector<std::pair<std::string,std::string>>& attrs,
+			       const char* name) {
+    for(auto& a : attrs) {
+      if(a.first == name) return &a.second;
+    }
+    static const std::string empty;
+    return &empty;
+  }
+}
+
+/* Constructors */
+
+XcspReader::XcspReader(std::istream& in, Handler& handler):
+  in(in), handler(handler), buffer(bufferSize), pos(0), end(0),
+  rooted(false), malformed(false) {}
+
+/* Input */
+
+int XcspReader::get() {
+  if(pos == end) {
+    in.read(buffer.data(), buffer.size());
+    end = in.gcount();
+    pos = 0;
+    if(!end) return -1;
+  }
+  return static_cast<unsigned char>(buffer[pos++]);
+}
+
+int XcspReader::peek() {
+  auto c = get();
+  if(c >= 0) pos--;
+  return c;
+}
+
+void XcspReader::skipPast(const char* terminator, std::string* text) {
+  auto n = strlen(terminator);
+  std::string skipped;
+  int c;
+  while((c = get()) >= 0) {
+    skipped += static_cast<char>(c);
+    if(skipped.size() >= n && !skipped.compare(skipped.size()-n, n, terminator)) {
+      if(text) *text += skipped.substr(0, skipped.size()-n);
+      return;
+    }
+  }
+  malformed = true;
+}
+
+std::string XcspReader::name() {
+  std::string ret;
+  int c;
+  while((c = peek()) >= 0 &&
+	(isalnum(c) || c == '_' || c == '-' || c == ':' || c == '.')) {
+    ret += static_cast<char>(get());
+  }
+  return ret;
+}
+
+/* Tags */
+
+void XcspReader::startTag() {
+  auto tag = name();
+  if(tag.empty()) {
+    malformed = true;
+    return;
+  }
+  // The document is a single instance element
+  if(names.empty()) {
+    if(rooted || tag != "instance") {
+      malformed = true;
+      return;
+    }
+    rooted = true;
+  }
+  std::vector<std::pair<std::string,std::string>> attrs;
+  int c;
+  while(true) {
+    while((c = get()) >= 0 && isspace(c));
+    if(c < 0) {
+      malformed = true;
+      return;
+    }
+    if(c == '>' || c == '/') break;
+    pos--;
+    auto attr = name();
+    while((c = get()) >= 0 && isspace(c));
+    if(attr.empty() || c != '=') {
+      malformed = true;
+      return;
+    }
+    while((c = get()) >= 0 && isspace(c));
+    if(c != '"' && c != '\'') {
+      malformed = true;
+      return;
+    }
+    std::string value;
+    auto quote = c;
+    while((c = get()) >= 0 && c != quote) {
+      value += static_cast<char>(c);
+    }
+    decode(value);
+    attrs.emplace_back(std::move(attr), std::move(value));
+  }
+  auto empty = (c == '/');
+  if(empty && get() != '>') {
+    malformed = true;
+    return;
+  }
+  start(tag, attrs);
+  if(empty) {
+    std::string text;
+    finish(tag, text);
+  }
+  else {
+    names.push_back(tag);
+    texts.emplace_back();
+  }
+}
+
+void XcspReader::endTag() {
+  auto tag = name();
+  int c;
+  while((c = get()) >= 0 && isspace(c));
+  if(c != '>' || names.empty() || names.back() != tag) {
+    malformed = true;
+    return;
+  }
+  auto text = std::move(texts.back());
+  names.pop_back();
+  texts.pop_back();
+  decode(text);
+  finish(tag, text);
+}
+
+/* Elements */
+
+void XcspReader::start(const std::string& name,
+		       std::vector<std::pair<std::string,std::string>>& attrs) {
+  // Text of a container is not used, only whitespace since its last
+  // child is kept
+  if(!texts.empty()) texts.back().clear();
+  if(name == "variable") {
+    handler.variable(*attribute(attrs, "name"), *attribute(attrs, "domain"));
+  }
+  else if(name == "predicate" || name == "constraint") {
+    current = std::move(attrs);
+    parameters.clear();
+    expression.clear();
+  }
+  else if(name == "domain") {
+    current = std::move(attrs);
+  }
+}
+
+void XcspReader::finish(const std::string& name, std::string& text) {
+  if(name == "domain") {
+    handler.domain(*attribute(current, "name"), text);
+  }
+  else if(name == "parameters") {
+    parameters = std::move(text);
+  }
+  else if(name == "functional") {
+    expression = std::move(text);
+  }
+  else if(name == "predicate") {
+    handler.predicate(*attribute(current, "name"), parameters, expression);
+  }
+  else if(name == "constraint") {
+    handler.constraint(*attribute(current, "name"), *attribute(current, "scope"),
+		       *attribute(current, "reference"), parameters);
+  }
+}
+
+/* Reading */
+
+bool XcspReader::read() {
+  int c;
+  while(!malformed && (c = get()) >= 0) {
+    if(c != '<') {
+      if(!texts.empty()) texts.back() += static_cast<char>(c);
+      continue;
+    }
+    c = get();
+    if(c == '/') endTag();
+    else if(c == '?') skipPast("?>");
+    else if(c == '!') {
+      if(peek() == '-') skipPast("-->");
+      else if(peek() == '[') {
+	// CDATA section: its content is text
+	std::string cdata;
+	skipPast("[");
+	skipPast("[");
+	skipPast("]]>", &cdata);
+	if(!texts.empty()) texts.back() += cdata;
+      }
+      else skipPast(">");
+    }
+    else if(c >= 0) {
+      pos--;
+      startTag();
+    }
+    else malformed = true;
+  }
+  return !malformed && rooted && names.empty();
+}
@@ -0,0 +1,149 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file XcspReader.h
+ * \brief XcspReader class header.
+ * \author Florian Galinier
+ * \version 0.1
+ * \date 19/10/26
+ *
+ * Streaming reader of XCSP 2 instances.
+ *
+ */
+
+#pragma once
+#include <istream>
+#include <string>
+#include <vector>
+#include <utility>
+
+/**
+ * \class XcspReader
+ * \brief Streaming (SAX-style) reader of XCSP 2 instances.
+ *
+ * The instance is read from a stream through a fixed size buffer and
+ * reported element by element to a handler, without building a
+ * document tree. Only the subset of XML used by XCSP is understood
+ * (elements, attributes, text, comments, CDATA, processing
+ * instructions, predefined entities).
+ *
+ * \author Florian Galinier
+ */
+class XcspReader {
+ public:
+  /**
+   * \brief Receiver of the elements of an instance.
+   */
+  class Handler {
+  public:
+    virtual ~Handler() noexcept {}
+    /**
+     * A domain.
+     * \param name The domain name.
+     * \param values The values (e.g. "1..3 7").
+     */
+    virtual void domain(const std::string& name, const std::string& values) {}
+    /**
+     * A variable.
+     * \param name The variable name.
+     * \param domain The domain name.
+     */
+    virtual void variable(const std::string& name, const std::string& domain) {}
+    /**
+     * A predicate.
+     * \param name The predicate name.
+     * \param parameters The formal parameters (e.g. "int X int Y").
+     * \param expression The functional expression.
+     */
+    virtual void predicate(const std::string& name,
+			   const std::string& parameters,
+			   const std::string& expression) {}
+    /**
+     * A constraint.
+     * \param name The constraint name.
+     * \param scope The variables in scope.
+     * \param reference The predicate or global constraint name.
+     * \param parameters The effective parameters.
+     */
+    virtual void constraint(const std::string& name,
+			    const std::string& scope,
+			    const std::string& reference,
+			    const std::string& parameters) {}
+  };
+ private:
+  std::istream& in;
+  Handler& handler;
+  std::vector<char> buffer;
+  size_t pos;
+  size_t end;
+  bool rooted;
+  bool malformed;
+  /* Element stack and text of open elements */
+  std::vector<std::string> names;
+  std::vector<std::string> texts;
+  /* Attributes of the current predicate or constraint */
+  std::vector<std::pair<std::string,std::string>> current;
+  std::string parameters;
+  std::string expression;
+
+  /**
+   * Return the next character (-1 at end of stream).
+   */
+  int get();
+  /**
+   * Return the next character without consuming it.
+   */
+  int peek();
+  /**
+   * Skip input up to and including the given terminator.
+   * \param terminator The terminator.
+   * \param text If not null, receives the skipped input.
+   */
+  void skipPast(const char* terminator, std::string* text = nullptr);
+  /**
+   * Read a name (element or attribute).
+   */
+  std::string name();
+  /**
+   * Read a start tag (after '<') and report it.
+   */
+  void startTag();
+  /**
+   * Read an end tag (after '</') and report it.
+   */
+  void endTag();
+  /**
+   * Called when an element starts.
+   */
+  void start(const std::string& name,
+	     std::vector<std::pair<std::string,std::string>>& attrs);
+  /**
+   * Called when an element ends.
+   */
+  void finish(const std::string& name, std::string& text);
+ public:
+  /**
+   * Create a reader.
+   * \param in The stream of the instance.
+   * \param handler The receiver of elements.
+   */
+  XcspReader(std::istream& in, Handler& handler);
+  /**
+   * Read the instance until its end.
+   * \return false if the document is malformed, truncated (empty
+   * included) or its root is not an instance element.
+   */
+  bool read();
+};
@@ -58,3 +58,22 @@ TEST(ChromosomTests, MutationTest) {
   delete c1;
   delete c2;
 }
+
+TEST(ChromosomTests, FeasibleMutationTest) {
+  std::vector<std::string> models;
+  models.push_back("scaffold/c0.chr");
+  models.push_back("scaffold/c1.chr");
+  Chromosom c(models);
+  CHECK(c.isValid());
+  CHECK(c.mutate(0.2) > 0);
+  CHECK(c.isFeasible());
+  CHECK(c.isValid());
+  CHECK_FALSE(c.getModels().at(0) == Model("scaffold/c0.chr"));
+
+  // An invalid model is mutated blindly and must be validated
+  std::vector<std::string> invalid;
+  invalid.push_back("tests/sample-rep/m1.chr");
+  Chromosom d(invalid);
+  d.mutate(1.0);
+  CHECK_FALSE(d.isFeasible());
+}
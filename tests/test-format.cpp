@@ -0,0 +1,54 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <CppUTest/TestHarness.h>
+#include "utils/Format.h"
+#include <cmath>
+#include <limits>
+#include <random>
+
+TEST_GROUP(FormatTests) {};
+
+TEST(FormatTests, Integers) {
+  for(long long v : {0ll, 7ll, -7ll, 10ll, 99ll, 100ll, -1234567ll, 2147483647ll,
+	std::numeric_limits<long long>::max(), std::numeric_limits<long long>::min()}) {
+    std::string s = "x";
+    Format::appendInteger(s, v);
+    STRCMP_EQUAL(("x"+std::to_string(v)).c_str(),s.c_str());
+  }
+}
+
+TEST(FormatTests, SameTextAsToString) {
+  std::vector<double> values = {0.0, -0.0, 1.0, -1.0, 0.5, 0.1, 1e-7, -1e-9,
+				0.0000005, 0.0000015, 0.0000025, 2.5e-7, 123.4567895,
+				1e9, 1e15, 1e300, -1e300,
+				std::numeric_limits<double>::max(),
+				std::numeric_limits<double>::infinity(),
+				std::nan("")};
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> unit(-2, 2);
+  std::uniform_int_distribution<int> exponent(-10, 12);
+  for(auto i = 0; i < 20000; i++) {
+    values.push_back(unit(gen)*std::pow(10.0, exponent(gen)));
+  }
+  // Halves of the last printed decimal
+  for(auto i = 0; i < 2000; i++) {
+    values.push_back((i+0.5)/1e6);
+  }
+  for(auto v : values) {
+    std::string s;
+    Format::appendFixed(s, v);
+    STRCMP_EQUAL(std::to_string(v).c_str(),s.c_str());
+  }
+}
@@ -53,3 +53,39 @@ TEST(GAChromosomTests, OnePointCrossoverTest) {
   delete sis;
   delete bro;
 }
+
+TEST(GAChromosomTests, OnePointIntraCrossoverTest) {
+  std::vector<std::string> dadModels;
+  std::vector<std::string> momModels;
+  dadModels.push_back("tests/sample-rep/m1.chr");
+  dadModels.push_back("tests/sample-rep/m2.chr");
+  momModels.push_back("tests/sample-rep/m3.chr");
+  momModels.push_back("tests/sample-rep/m4.chr");
+  GAChromosom* dad = new GAChromosom(dadModels);
+  GAChromosom* mom = new GAChromosom(momModels);
+  GAChromosom* sis = new GAChromosom();
+  GAChromosom* bro = new GAChromosom();
+
+  GAChromosom::onePointIntraCrossover(*dad,*mom,sis,bro);
+
+  // Each gene of an offspring comes from the same position in a parent,
+  // and the other offspring gets the gene of the other parent.
+  for(auto i = 0u; i < dad->getModels().size(); i++) {
+    auto& d = *dad->getModels()[i].getVal();
+    auto& m = *mom->getModels()[i].getVal();
+    auto& s = *sis->getModels()[i].getVal();
+    auto& b = *bro->getModels()[i].getVal();
+    LONGS_EQUAL(d.size(),s.size());
+    LONGS_EQUAL(d.size(),b.size());
+    LONGS_EQUAL(d.size(),sis->getModels()[i].getDomains()->size());
+    for(auto j = 0u; j < d.size(); j++) {
+      CHECK((s[j] == d[j] && b[j] == m[j]) ||
+	    (s[j] == m[j] && b[j] == d[j]));
+    }
+  }
+
+  delete dad;
+  delete mom;
+  delete sis;
+  delete bro;
+}
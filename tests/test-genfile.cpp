@@ -0,0 +1,141 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <CppUTest/TestHarness.h>
+#include "model/GenFile.h"
+#include "model/Population.h"
+#include "model/Matrix.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+TEST_GROUP(GenFileTests) {};
+
+TEST(GenFileTests, WriteAndRead) {
+  Chromosom::setNbModels(2);
+  Population pop("tests/sample-rep");
+  for(auto i = 0; i < pop.size(); i++) {
+    Objectives sc(2);
+    for(auto k = 0; k < Objectives::KINDS; k++) {
+      sc.set(static_cast<Objectives::Kind>(k),0,1,i+k/10.0);
+    }
+    static_cast<GAChromosom&>(pop.individual(i)).score(sc);
+  }
+  Matrix popScores(pop.size());
+  popScores.set(0,1,0.5);
+
+  GenFile::write("tests/gen-test", 3, pop, &popScores);
+  {
+    GenFile file("tests/gen-test");
+    LONGS_EQUAL(3,file.generation());
+    LONGS_EQUAL(pop.size(),file.size());
+    LONGS_EQUAL(2,file.nbModels());
+    LONGS_EQUAL(Objectives::KINDS,file.nbObjectives());
+    CHECK(file.hasPopScores());
+    // Files store doubles: scores of float matrices (MATRIX_FLOAT)
+    // are widened
+    DOUBLES_EQUAL(0.5,file.popScore(0,1),1e-6);
+    for(auto i = 0; i < pop.size(); i++) {
+      auto& models = static_cast<GAChromosom&>(pop.individual(i)).getModels();
+      for(auto k = 0u; k < models.size(); k++) {
+	auto genes = file.getGenes(i,k);
+	auto val = models[k].getVal();
+	LONGS_EQUAL(val->size(),genes.size());
+	for(auto j = 0u; j < genes.size(); j++) {
+	  LONGS_EQUAL((*val)[j],genes[j]);
+	}
+      }
+      DOUBLES_EQUAL(i+0.2,file.score(i,2,0,1),1e-6);
+      DOUBLES_EQUAL(i+0.4,file.score(i,4,1,0),1e-6);
+    }
+    CHECK_THROWS(std::out_of_range,file.getGenes(pop.size(),0));
+
+    // Text view is the former text generation file
+    {
+      Logger l("tests/gen-test.txt");
+      l << popScores;
+      l << pop;
+      l.flush();
+    }
+    std::ifstream txt("tests/gen-test.txt");
+    std::stringstream expected;
+    expected << txt.rdbuf();
+    STRCMP_EQUAL(expected.str().c_str(),file.to_string().c_str());
+  }
+  std::remove("tests/gen-test");
+  std::remove("tests/gen-test.txt");
+
+  CHECK_THROWS(std::runtime_error,GenFile("tests/PetriNet.xml"));
+}
+
+TEST(GenFileTests, DeltaRoundTrip) {
+  Chromosom::setNbModels(2);
+  Population pop("tests/sample-rep");
+  auto setScore = [](GAGenome& g, double v) {
+    Objectives sc(2);
+    sc.set(Objectives::COSINE,0,1,v);
+    static_cast<GAChromosom&>(g).score(sc);
+  };
+  auto change = [](GAGenome& g, int v) {
+    auto& models = static_cast<GAChromosom&>(g).getModels();
+    auto genes = std::make_shared<Genes>(*models[0].getVal());
+    (*genes)[0] += v;
+    models[0].setVal(genes);
+  };
+  // Four distinct individuals
+  pop.add(pop.individual(0));
+  pop.add(pop.individual(1));
+  change(pop.individual(2), 100);
+  change(pop.individual(3), 100);
+  for(auto i = 0; i < pop.size(); i++) {
+    setScore(pop.individual(i), i);
+  }
+  GenFile::Writer writer(3);
+  std::vector<std::string> expected;
+  for(auto gen = 1u; gen <= 4; gen++) {
+    // Survivors in another order, a changed score and a new individual
+    Population next;
+    for(auto i = pop.size()-1; i >= 0; i--) {
+      next.add(pop.individual(i));
+    }
+    setScore(next.individual(0), 10.0*gen);
+    change(next.individual(1), gen);
+    Matrix popScores(next.size());
+    popScores.set(0,1,gen);
+    popScores.set(2,1,0.5);
+
+    auto size = writer.write("tests/gen-delta"+std::to_string(gen), gen, next, &popScores);
+    GenFile::write("tests/gen-key", gen, next, &popScores);
+    GenFile key("tests/gen-key");
+    expected.push_back(key.to_string());
+    if(gen % 3 != 1) {
+      std::ifstream full("tests/gen-key", std::ios_base::binary | std::ios_base::ate);
+      CHECK(size < static_cast<size_t>(full.tellg()));
+    }
+    pop = next;
+  }
+  for(auto gen = 1u; gen <= 4; gen++) {
+    GenFile file("tests/gen-delta"+std::to_string(gen));
+    LONGS_EQUAL(gen,file.generation());
+    CHECK_EQUAL(gen == 1 || gen == 4,file.isKeyframe());
+    STRCMP_EQUAL(expected[gen-1].c_str(),file.to_string().c_str());
+  }
+  // A delta needs its base
+  std::remove("tests/gen-delta2");
+  CHECK_THROWS(std::runtime_error,GenFile("tests/gen-delta3"));
+  for(auto gen = 1u; gen <= 4; gen++) {
+    std::remove(("tests/gen-delta"+std::to_string(gen)).c_str());
+  }
+  std::remove("tests/gen-key");
+}
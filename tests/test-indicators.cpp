@@ -0,0 +1,70 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <CppUTest/TestHarness.h>
+#include "model/Indicators.h"
+#include <random>
+#include <vector>
+
+TEST_GROUP(IndicatorsTests) {};
+
+TEST(IndicatorsTests, Hypervolume) {
+  // Staircase of 3 points: 3x1 + 2x1 + 1x1
+  DOUBLES_EQUAL(6,Indicators::hypervolume({{1,3},{2,2},{3,1},{1,1}}),1e-12);
+  DOUBLES_EQUAL(1,Indicators::hypervolume({{1,1,1}}),1e-12);
+  // Two boxes of 2 sharing the unit cube
+  DOUBLES_EQUAL(3,Indicators::hypervolume({{2,1,1},{1,2,1}}),1e-12);
+  DOUBLES_EQUAL(0,Indicators::hypervolume({}),0);
+  LONGS_EQUAL(3,Indicators::front({{1,3},{2,2},{3,1},{1,1},{2,2}}).size());
+}
+
+TEST(IndicatorsTests, Incremental) {
+  // The archive hypervolume, updated point by point, is the one of
+  // every point
+  std::mt19937 g(7);
+  std::uniform_real_distribution<double> u(0,1);
+  for(auto d = 2u; d <= 4; d++) {
+    Indicators ind;
+    std::vector<Indicators::Point> all;
+    for(auto i = 0; i < 60; i++) {
+      Indicators::Point p(d);
+      for(auto& x : p) x = u(g);
+      all.push_back(p);
+      ind.add(p);
+    }
+    DOUBLES_EQUAL(Indicators::hypervolume(all),ind.hypervolume(),1e-9);
+    LONGS_EQUAL(Indicators::front(all).size(),ind.archive().size());
+  }
+}
+
+TEST(IndicatorsTests, Convergence) {
+  Indicators ind;
+  ind.update({{1,1},{0.5,0.5}});
+  LONGS_EQUAL(1,ind.lastFront());
+  DOUBLES_EQUAL(0,ind.igd(),1e-12);
+  // A better front: the previous one is 0.5 away (normalized) from
+  // both archive points
+  ind.update({{2,1},{1,2}});
+  DOUBLES_EQUAL(3,ind.hypervolume(),1e-12);
+  DOUBLES_EQUAL(0,ind.igd(),1e-12);
+  DOUBLES_EQUAL(0.5,ind.igd({{1,1}}),1e-12);
+  CHECK(!ind.stalled(0.01,2));
+  // No improvement over 2 generations
+  ind.update({{1,1}});
+  CHECK(!ind.stalled(0.01,2));
+  ind.update({{2,1}});
+  CHECK(ind.stalled(0.01,2));
+  CHECK(!ind.stalled(0,2));
+}
@@ -0,0 +1,77 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <CppUTest/TestHarness.h>
+#include "utils/Logger.h"
+#include "utils/LogSink.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+TEST_GROUP(LoggerTests) {};
+
+static std::string content(const std::string& file) {
+  std::ifstream in(file);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  return ss.str();
+}
+
+TEST(LoggerTests, TruncateAndAppend) {
+  {
+    Logger l("tests/log-test");
+    l << "old";
+  }
+  {
+    Logger l("tests/log-test");
+    l << "a" << 1 << " ";
+  }
+  {
+    Logger l("tests/log-test",std::ios_base::app);
+    l << "b";
+  }
+  LogSink::instance().flush();
+  STRCMP_EQUAL("a1 b",content("tests/log-test").c_str());
+  std::remove("tests/log-test");
+}
+
+TEST(LoggerTests, ConcurrentAppend) {
+  {
+    Logger l("tests/log-test");
+  }
+  std::vector<std::thread> threads;
+  for(auto t = 0; t < 4; t++) {
+    threads.emplace_back([] {
+	for(auto i = 0; i < 100; i++) {
+	  Logger l("tests/log-test",std::ios_base::app);
+	  l << "line\n";
+	}
+      });
+  }
+  for(auto& t : threads) {
+    t.join();
+  }
+  LogSink::instance().flush();
+  std::istringstream in(content("tests/log-test"));
+  std::string line;
+  auto nb = 0;
+  while(std::getline(in,line)) {
+    STRCMP_EQUAL("line",line.c_str());
+    nb++;
+  }
+  LONGS_EQUAL(400,nb);
+  std::remove("tests/log-test");
+}
@@ -14,6 +14,7 @@
 
 #include <CppUTest/TestHarness.h>
 #include "model/Matrix.h"
+#include <algorithm>
 
 TEST_GROUP(MatrixTests) {};
 
@@ -62,3 +63,134 @@ TEST(MatrixTests, MatrixSubstraction) {
   delete m8;
   delete m9;
 }
+
+TEST(MatrixTests, TriangularStorage) {
+  Matrix m(5);
+  LONGS_EQUAL(10,m.count());
+  for(auto i = 0u; i < 5; i++) {
+    for(auto j = i+1; j < 5; j++) {
+      m.set(i,j,i*10+j);
+    }
+  }
+  // Symmetric, null diagonal
+  DOUBLES_EQUAL(14,m[1][4],0.0);
+  DOUBLES_EQUAL(14,m[4][1],0.0);
+  DOUBLES_EQUAL(0,m[2][2],0.0);
+  m.set(3,1,7);
+  DOUBLES_EQUAL(7,m.get(1,3),0.0);
+  CHECK_THROWS(std::out_of_range,m.set(2,2,1));
+  CHECK_THROWS(std::out_of_range,m[5]);
+
+  // Reductions on the upper triangle
+  double sum = 0, min = 1000;
+  for(auto k = 0u; k < m.count(); k++) {
+    sum += m.data()[k];
+    min = (m.data()[k] < min) ? m.data()[k] : min;
+  }
+  DOUBLES_EQUAL(sum/10,m.average(),1e-9);
+  DOUBLES_EQUAL(min,m.min(),0.0);
+  DOUBLES_EQUAL((2+12+23+24)/5.0,m.lineAverage(2),1e-9);
+  DOUBLES_EQUAL((1+2+3+4)/5.0,m.lineAverage(0),1e-9);
+  DOUBLES_EQUAL((4+14+24+34)/5.0,m.lineAverage(4),1e-9);
+}
+
+TEST(MatrixTests, MatrixComparison) {
+  Matrix m1(6), m2(6), res(6);
+  for(auto i = 0u; i < 6; i++) {
+    for(auto j = i+1; j < 6; j++) {
+      m1.set(i,j,i+j);
+      m2.set(i,j,i+j);
+    }
+  }
+  LONGS_EQUAL(Matrix::EQUAL,Matrix::compare(m1,m2));
+  CHECK(m1 >= m2);
+  CHECK(!(m1 > m2));
+  CHECK(!m1.dominates(m2));
+
+  m1.set(4,5,10);
+  LONGS_EQUAL(Matrix::GREATER,Matrix::compare(m1,m2));
+  CHECK(m1 > m2);
+  CHECK(m1.dominates(m2));
+  CHECK(!(m2 >= m1));
+
+  m1.set(0,1,0);
+  LONGS_EQUAL(Matrix::INCOMPARABLE,Matrix::compare(m1,m2));
+  CHECK(!(m1 >= m2));
+  CHECK(!m2.dominates(m1));
+
+  m1.set(0,1,1.00001);
+  LONGS_EQUAL(Matrix::GREATER,Matrix::compare(m1,m2,0.0001));
+
+  Matrix other(3);
+  CHECK_THROWS(std::invalid_argument,Matrix::compare(m1,other));
+}
+
+TEST(MatrixTests, MatrixArithmetic) {
+  Matrix m1(6), m2(6), res(6);
+  for(auto i = 0u; i < 6; i++) {
+    for(auto j = i+1; j < 6; j++) {
+      m1.set(i,j,i+j);
+      m2.set(i,j,1);
+    }
+  }
+  Matrix::subtract(m1,m2,res);
+  DOUBLES_EQUAL(8,res[4][5],0.0);
+  DOUBLES_EQUAL(0,res[1][0],0.0);
+  Matrix::axpy(2,m1,m2,res);
+  DOUBLES_EQUAL(19,res[5][4],0.0);
+  Matrix::add(m1,m2,m1);
+  DOUBLES_EQUAL(10,m1[4][5],0.0);
+  m1 -= m2;
+  m1 *= 0.5;
+  DOUBLES_EQUAL(4.5,m1[4][5],0.0);
+  m1 += m2;
+  DOUBLES_EQUAL(5.5,m1[4][5],0.0);
+  Matrix other(3);
+  CHECK_THROWS(std::invalid_argument,Matrix::subtract(m1,other,res));
+}
+
+TEST(MatrixTests, FixedKernels) {
+  // Sizes 2, 3 and 5 use the kernels of FixedMatrix, 4 and 6 do not
+  for(size_t n : {2, 3, 4, 5, 6}) {
+    Matrix m(n), m2(n);
+    double sum = 0, min = 100;
+    for(auto i = 0u; i < n; i++) {
+      for(auto j = i+1; j < n; j++) {
+	double v = (i*7+j*3)%11+0.5;
+	m.set(i,j,v);
+	m2.set(i,j,v);
+	sum += v;
+	min = std::min(min, v);
+      }
+    }
+    DOUBLES_EQUAL(sum/(n*(n-1)/2),m.average(),1e-6);
+    DOUBLES_EQUAL(min,m.min(),0.0);
+    LONGS_EQUAL(Matrix::EQUAL,Matrix::compare(m,m2));
+    m2.set(0,n-1,m[0][n-1]-1);
+    LONGS_EQUAL(Matrix::GREATER,Matrix::compare(m,m2));
+    CHECK(m.dominates(m2));
+    LONGS_EQUAL(Matrix::EQUAL,Matrix::compare(m,m2,1.5));
+    if(n > 2) {
+      m2.set(n-2,n-1,m[n-2][n-1]+1);
+      LONGS_EQUAL(Matrix::INCOMPARABLE,Matrix::compare(m,m2));
+    }
+    m.set(0,n-1,-1);
+    DOUBLES_EQUAL(-1,m.min(),0.0);
+  }
+}
+
+TEST(MatrixTests, Copies) {
+  Matrix m(3);
+  m.set(0,1,1);
+  m.set(0,2,4);
+  m.set(1,2,2);
+  // Copies of small and large matrices
+  Matrix c(m), d(6);
+  d.set(4,5,1);
+  DOUBLES_EQUAL(2,c[2][1],0.0);
+  c = d;
+  LONGS_EQUAL(6,c.size());
+  DOUBLES_EQUAL(1,c[5][4],0.0);
+  d = m;
+  DOUBLES_EQUAL(4,d[2][0],0.0);
+}
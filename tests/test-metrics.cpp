@@ -0,0 +1,44 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <CppUTest/TestHarness.h>
+#include "model/Metrics.h"
+#include <algorithm>
+#include <string>
+
+TEST_GROUP(MetricsTests) {};
+
+TEST(MetricsTests, Formats) {
+  GenerationMetrics m(3);
+  m.evaluation = 12.5;
+  m.mutations = 7;
+  auto header = GenerationMetrics::header();
+  STRCMP_EQUAL("generation,crossover_ms,",header.substr(0,24).c_str());
+  auto csv = m.to_string(GenerationMetrics::Format::CSV);
+  // As many values as columns
+  LONGS_EQUAL(std::count(header.begin(),header.end(),','),
+	      std::count(csv.begin(),csv.end(),','));
+  STRCMP_EQUAL("3,0.000,0.000,0.000,12.500,",csv.substr(0,27).c_str());
+  auto json = m.to_string(GenerationMetrics::Format::JSONL);
+  CHECK(json.find("{\"generation\":3,") == 0);
+  CHECK(json.find("\"mutations\":7,") != std::string::npos);
+  STRCMP_EQUAL("}\n",json.substr(json.size()-2).c_str());
+
+  // Process counters are differences
+  m.start();
+  m.stop();
+  LONGS_EQUAL(0,m.launches);
+  LONGS_EQUAL(0,m.networkHits);
+}
@@ -14,8 +14,12 @@
 
 #include <CppUTest/TestHarness.h>
 #include "model/Model.h"
+#include "model/Xcsp.h"
+#include "utils/Scratch.h"
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <stdexcept>
 
 TEST_GROUP(ModelTests) {};
 
@@ -29,3 +33,49 @@ TEST(ModelTests, FirstTest) {
   LONGS_EQUAL(testc->getVal()->size(),testc->getDomains()->size());
   delete testc;
 }
+
+TEST(ModelTests, CopyOnWrite) {
+  Model m1("tests/sample-rep/m1.chr");
+  Model m2(m1);
+  CHECK(m1.getVal() == m2.getVal());
+  DOUBLES_EQUAL(m1.squaredNorm(),m2.squaredNorm(),0.0001);
+
+  auto before = m1.getVal()->at(0);
+  m2.editVal()[0] = before + 1;
+
+  // Modification of the copy does not affect the original
+  CHECK(m1.getVal() != m2.getVal());
+  LONGS_EQUAL(before,m1.getVal()->at(0));
+  LONGS_EQUAL(before+1,m2.getVal()->at(0));
+  CHECK(m1 != m2);
+  DOUBLES_EQUAL(m1.squaredNorm() + 2*before + 1,m2.squaredNorm(),0.0001);
+}
+
+TEST(ModelTests, LoadDomains) {
+  auto before = Model::loadMetrics();
+  auto d = Model::loadDomains("javasmall/c7.xml");
+  auto x = Xcsp::load("javasmall/c7.xml");
+  // Domains are those of the shared network
+  CHECK(d.get() == &x->getDomains());
+  CHECK(d == Model::loadDomains("javasmall/c7.xml"));
+  auto after = Model::loadMetrics();
+  LONGS_EQUAL(before.requests+2,after.requests);
+  CHECK(after.files <= before.files+1);
+}
+
+TEST(ModelTests, LoadTruncatedDomains) {
+  // A truncated file is not read as partial domains
+  std::ifstream in("javasmall/c7.xml");
+  std::string content((std::istreambuf_iterator<char>(in)),
+		      std::istreambuf_iterator<char>());
+  Scratch file(".xml");
+  {
+    std::ofstream out(file.path());
+    out << content.substr(0, content.find("</variables>"));
+  }
+  CHECK(!Xcsp::load(file.path())->isValid());
+  CHECK_THROWS(std::runtime_error, Model::loadDomains(file.path()));
+  CHECK_THROWS(std::runtime_error, Model::loadDomains("missing.xml"));
+  Scratch empty(".xml");
+  CHECK_THROWS(std::runtime_error, Model::loadDomains(empty.path()));
+}
@@ -0,0 +1,55 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <CppUTest/TestHarness.h>
+#include "model/Objectives.h"
+
+TEST_GROUP(ObjectivesTests) {};
+
+TEST(ObjectivesTests, KindsAndPairs) {
+  Objectives o(3), p(3);
+  LONGS_EQUAL(3,o.size());
+  LONGS_EQUAL(3,o.count());
+  o.set(Objectives::HAMMING,0,1,1);
+  o.set(Objectives::HAMMING,2,0,4);
+  o.set(Objectives::LEVEXTERN,1,2,2);
+  DOUBLES_EQUAL(4,o.get(Objectives::HAMMING,0,2),0.0);
+  DOUBLES_EQUAL(0,o.get(Objectives::HAMMING,1,2),0.0);
+  DOUBLES_EQUAL(2,o.get(Objectives::LEVEXTERN,2,1),0.0);
+  DOUBLES_EQUAL(5/3.0,o.average(Objectives::HAMMING),1e-12);
+  DOUBLES_EQUAL(0,o.min(Objectives::HAMMING),0.0);
+  CHECK(o.isNull(Objectives::COSINE));
+  CHECK(!o.isNull(Objectives::HAMMING));
+  CHECK_THROWS(std::out_of_range,o.set(Objectives::COSINE,1,1,0));
+
+  // Kinds are compared independently
+  p.set(Objectives::HAMMING,0,1,1);
+  CHECK(o.dominates(Objectives::HAMMING,p));
+  CHECK(!p.dominates(Objectives::HAMMING,o));
+  CHECK(!o.dominates(Objectives::COSINE,p));
+  LONGS_EQUAL(Matrix::EQUAL,o.compare(Objectives::COSINE,p));
+  CHECK_THROWS(std::invalid_argument,o.compare(Objectives::COSINE,Objectives(4)));
+
+  auto m = o.matrix(Objectives::HAMMING);
+  LONGS_EQUAL(3,m.size());
+  DOUBLES_EQUAL(4,m[2][0],0.0);
+
+  // Reset keeps the buffer of the same number of models
+  auto data = o.data(Objectives::COSINE);
+  o.reset(3);
+  CHECK(data == o.data(Objectives::COSINE));
+  CHECK(o.isNull(Objectives::HAMMING));
+  o.reset(4);
+  LONGS_EQUAL(6,o.count());
+}
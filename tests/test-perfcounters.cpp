@@ -0,0 +1,97 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <CppUTest/TestHarness.h>
+#include "utils/PerfCounters.h"
+#include "model/Metrics.h"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+TEST_GROUP(PerfCountersTests) {
+  void teardown() {
+    PerfCounters::disable();
+  }
+};
+
+TEST(PerfCountersTests, Disabled) {
+  CHECK(!PerfCounters::enabled());
+  for(auto v : PerfCounters::read()) {
+    DOUBLES_EQUAL(0,v,0);
+  }
+  // Metrics have no hardware columns
+  CHECK(GenerationMetrics::header().find("_cycles") == std::string::npos);
+}
+
+TEST(PerfCountersTests, Enable) {
+  if(!PerfCounters::enable()) {
+    // Kernel or processor without counters: the reason is given and
+    // nothing is counted
+    CHECK(!PerfCounters::error().empty());
+    CHECK(!PerfCounters::enabled());
+    CHECK(!PerfCounters::counted(PerfCounters::INSTRUCTIONS));
+    return;
+  }
+  CHECK(PerfCounters::enabled());
+  volatile double x = 0;
+  auto work = [&x]() {
+    for(auto i = 0; i < 1000000; i++) x = x+i;
+  };
+  auto instructions = PerfCounters::counted(PerfCounters::INSTRUCTIONS);
+  auto before = PerfCounters::read();
+  work();
+  auto mid = PerfCounters::read();
+  if(instructions)
+    CHECK(mid[PerfCounters::INSTRUCTIONS]-before[PerfCounters::INSTRUCTIONS] > 1000000);
+
+  // A thread started after enable is counted once a read() sees it
+  // alive, here while it waits (this thread sleeps while it works)
+  std::atomic<bool> go(false), worked(false);
+  std::thread t([&]() {
+      while(!go) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      work();
+      worked = true;
+    });
+  mid = PerfCounters::read();
+  go = true;
+  while(!worked) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  auto after = PerfCounters::read();
+  if(instructions)
+    CHECK(after[PerfCounters::INSTRUCTIONS]-mid[PerfCounters::INSTRUCTIONS] > 1000000);
+  // Counts of the thread are kept once it has ended
+  t.join();
+  auto ended = PerfCounters::read();
+  for(auto e = 0u; e < PerfCounters::events; e++) {
+    CHECK(mid[e] >= before[e]);
+    CHECK(after[e] >= mid[e]);
+    CHECK(ended[e] >= after[e]);
+  }
+
+  // Counts of phases are columns of metrics
+  GenerationMetrics m(1);
+  m.start();
+  work();
+  m.count(GenerationMetrics::EVALUATION);
+  auto header = GenerationMetrics::header();
+  auto line = m.to_string(GenerationMetrics::Format::JSONL);
+  for(auto e = 0u; e < PerfCounters::events; e++) {
+    auto event = static_cast<PerfCounters::Event>(e);
+    auto column = std::string("evaluation_")+PerfCounters::name(event);
+    CHECK((header.find(column) != std::string::npos) == PerfCounters::counted(event));
+  }
+  if(PerfCounters::counted(PerfCounters::CYCLES))
+    CHECK(line.find("\"evaluation_cycles\":0,") == std::string::npos);
+}
@@ -15,6 +15,10 @@
 #include <CppUTest/TestHarness.h>
 #include "model/Population.h"
 #include "utils/Directory.h"
+#include "utils/Scratch.h"
+#include <fstream>
+#include <stdexcept>
+#include <sys/stat.h>
 
 TEST_GROUP(PopulationTests) {};
 
@@ -27,3 +31,52 @@ TEST(PopulationTests, TestPopulationLoad) {
   LONGS_EQUAL(nb/Chromosom::getNbModels(),testc->size());
   delete testc;
 }
+
+TEST(PopulationTests, TestManifestOrder) {
+  auto files = Population::manifest("scaffold");
+  LONGS_EQUAL(100,files.size());
+  STRCMP_EQUAL("c0.chr",files[0].c_str());
+  STRCMP_EQUAL("c2.chr",files[2].c_str());
+  STRCMP_EQUAL("c10.chr",files[10].c_str());
+
+  Chromosom::setNbModels(2);
+  Population pop("scaffold");
+  LONGS_EQUAL(50,pop.size());
+  auto& models = static_cast<GAChromosom&>(pop.individual(1)).getModels();
+  CHECK(models[0] == Model("scaffold/c2.chr"));
+  CHECK(models[1] == Model("scaffold/c3.chr"));
+  // Domains are shared with every model of the same XCSP file
+  CHECK(models[0].getDomains() == Model("scaffold/c2.chr").getDomains());
+}
+
+TEST(PopulationTests, TestManifestCheck) {
+  auto dir = Scratch::directory()+"/manifest-test";
+  mkdir(dir.c_str(),0777);
+  for(auto f : {"c1.chr","c2.chr","c10.chr"}) {
+    std::ofstream out(dir+"/"+f);
+  }
+  // Without manifest, natural order, and no manifest is written
+  auto files = Population::manifest(dir);
+  LONGS_EQUAL(3,files.size());
+  STRCMP_EQUAL("c10.chr",files[2].c_str());
+  CHECK(!std::ifstream(dir+"/manifest"));
+
+  // Files added after the manifest follow the listed ones
+  {
+    std::ofstream out(dir+"/manifest");
+    out << "c10.chr\n# comment\nc1.chr\n";
+  }
+  files = Population::manifest(dir);
+  LONGS_EQUAL(3,files.size());
+  STRCMP_EQUAL("c10.chr",files[0].c_str());
+  STRCMP_EQUAL("c1.chr",files[1].c_str());
+  STRCMP_EQUAL("c2.chr",files[2].c_str());
+
+  // A stale entry is reported at once
+  {
+    std::ofstream out(dir+"/manifest", std::ios_base::app);
+    out << "c3.chr\n";
+  }
+  CHECK_THROWS(std::runtime_error, Population::manifest(dir));
+  Directory::remove(dir);
+}
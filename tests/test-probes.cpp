@@ -0,0 +1,159 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <CppUTest/TestHarness.h>
+#include "utils/LogSink.h"
+#include "utils/Probes.h"
+#include "utils/Scratch.h"
+#include "utils/ThreadPool.h"
+#include <chrono>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+TEST_GROUP(ProbesTests) {};
+
+TEST(ProbesTests, Stat) {
+  Probes::Stat s;
+  LONGS_EQUAL(0,s.count);
+  DOUBLES_EQUAL(0,s.mean(),0);
+  DOUBLES_EQUAL(0,s.quantile(0.5),0);
+  for(auto v = 1; v <= 100; v++) {
+    s.add(v);
+  }
+  LONGS_EQUAL(100,s.count);
+  DOUBLES_EQUAL(5050,s.sum,0);
+  DOUBLES_EQUAL(50.5,s.mean(),1e-9);
+  DOUBLES_EQUAL(1,s.min,0);
+  DOUBLES_EQUAL(100,s.max,0);
+  // 50 is in [32,64), 90 in [64,128) bounded by max
+  DOUBLES_EQUAL(64,s.quantile(0.5),0);
+  DOUBLES_EQUAL(100,s.quantile(0.9),0);
+  DOUBLES_EQUAL(1,s.quantile(0),0);
+
+  Probes::Stat t;
+  t.add(-3);
+  t.add(0.25);
+  s.merge(t);
+  LONGS_EQUAL(102,s.count);
+  DOUBLES_EQUAL(-3,s.min,0);
+  DOUBLES_EQUAL(100,s.max,0);
+}
+
+TEST(ProbesTests, ThreadsAreMerged) {
+  auto timer = Probes::probe("test timer", Probes::TIMER);
+  auto counter = Probes::probe("test counter", Probes::COUNTER);
+  LONGS_EQUAL(counter,Probes::probe("test counter", Probes::COUNTER));
+  Probes::merge();
+  Probes::reset();
+
+  ThreadPool pool(4);
+  pool.parallelFor(1000, [counter](size_t i) {
+      Probes::record(counter, 2);
+    });
+  // Values of a thread that ends are kept
+  std::thread([timer]() { Probes::Timer t(timer); }).join();
+
+  auto find = [](const std::string& name) {
+    for(auto& e : Probes::totals()) {
+      if(e.name == name) return e;
+    }
+    FAIL("Unknown probe");
+    return Probes::Entry();
+  };
+  LONGS_EQUAL(1,find("test timer").stat.count);
+  Probes::merge();
+  auto c = find("test counter");
+  LONGS_EQUAL(Probes::COUNTER,c.kind);
+  LONGS_EQUAL(1000,c.stat.count);
+  DOUBLES_EQUAL(2000,c.stat.sum,0);
+  CHECK(Probes::summary().find("test timer (ms)") != std::string::npos);
+
+  Probes::reset();
+  LONGS_EQUAL(0,find("test counter").stat.count);
+}
+
+#ifndef NO_PROBES
+TEST(ProbesTests, Macros) {
+  Probes::merge();
+  Probes::reset();
+  for(auto i = 0; i < 3; i++) {
+    PROBE_TIMER("test scope");
+    PROBE_COUNT("test count", i);
+    PROBE_VALUE("test value", i);
+  }
+  // A lap returns the duration it records, and starts the next one
+  auto t = Probes::Clock::now();
+  auto start = t;
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  auto lap = PROBE_LAP("test lap", t);
+  CHECK(lap >= 2);
+  CHECK(t > start);
+  Probes::merge();
+  for(auto& e : Probes::totals()) {
+    if(e.name == "test scope") LONGS_EQUAL(3,e.stat.count);
+    if(e.name == "test count") DOUBLES_EQUAL(3,e.stat.sum,0);
+    if(e.name == "test value") DOUBLES_EQUAL(2,e.stat.max,0);
+    if(e.name == "test lap") DOUBLES_EQUAL(lap,e.stat.sum,0);
+  }
+}
+#endif
+
+namespace {
+  bool contains(const std::vector<std::string>& lines, const std::string& text) {
+    for(auto& l : lines) {
+      if(l.find(text) != std::string::npos) return true;
+    }
+    return false;
+  }
+}
+
+TEST(ProbesTests, Trace) {
+  Scratch file(".json");
+  auto id = Probes::probe("test \"span\"", Probes::TIMER);
+  Probes::trace(file.path());
+  auto t = Probes::Clock::now();
+  Probes::span(id, t, t+std::chrono::microseconds(1500));
+  std::thread([id]() { Probes::Timer s(id); }).join();
+  Probes::endTrace();
+  // Spans are not traced after the end
+  Probes::span(id, t, t);
+  Probes::merge();
+  LogSink::instance().flush();
+
+  std::ifstream in(file.path());
+  std::vector<std::string> lines;
+  std::string line;
+  while(std::getline(in, line)) lines.push_back(line);
+  LONGS_EQUAL(7,lines.size());
+  STRCMP_EQUAL("[",lines[0].c_str());
+  STRCMP_EQUAL("]",lines[6].c_str());
+  // Each span follows the name of its thread, the process name ends
+  auto pid = std::to_string(getpid());
+  auto names = 0, spans = 0;
+  for(auto i = 1u; i < 5; i++) {
+    if(lines[i].find("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":"+pid) == 0)
+      names++;
+    if(lines[i].find("{\"name\":\"test \\\"span\\\"\",\"cat\":\"mdea\",\"ph\":\"X\",\"ts\":") == 0) {
+      CHECK(lines[i-1].find("thread_name") != std::string::npos);
+      spans++;
+    }
+  }
+  LONGS_EQUAL(2,names);
+  LONGS_EQUAL(2,spans);
+  CHECK(contains(lines, "\"args\":{\"name\":\"main\"}},"));
+  CHECK(contains(lines, ",\"dur\":1500.000000,"));
+  CHECK(lines[5].find("\"process_name\"") != std::string::npos);
+  Probes::reset();
+}
@@ -0,0 +1,74 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <CppUTest/TestHarness.h>
+#include "utils/Random.h"
+#include <thread>
+#include <vector>
+
+TEST_GROUP(RandomTests) {};
+
+TEST(RandomTests, SameKeySameStream) {
+  Random::seed(42);
+  Random r1(Random::Stream::CROSSOVER, 3, 7);
+  Random r2(Random::Stream::CROSSOVER, 3, 7);
+  Random r3(Random::Stream::CROSSOVER, 3, 8);
+  auto differ = false;
+  for(auto i = 0; i < 100; i++) {
+    auto a = r1.next();
+    LONGS_EQUAL(a, r2.next());
+    differ |= (a != r3.next());
+  }
+  CHECK(differ);
+}
+
+TEST(RandomTests, SeedChangesStream) {
+  Random::seed(1);
+  Random r1(Random::Stream::MUTATION, 1, 1);
+  Random::seed(2);
+  Random r2(Random::Stream::MUTATION, 1, 1);
+  CHECK(r1.next() != r2.next());
+}
+
+TEST(RandomTests, Bounds) {
+  Random::seed(42);
+  Random r;
+  for(auto i = 0; i < 1000; i++) {
+    auto v = r.nextInt(-3, 5);
+    CHECK(v >= -3 && v <= 5);
+    auto f = r.nextFloat(0.0, 1.0);
+    CHECK(f >= 0.0 && f < 1.0);
+  }
+  LONGS_EQUAL(4, r.nextInt(4, 4));
+}
+
+TEST(RandomTests, ScopeIsThreadIndependent) {
+  Random::seed(42);
+  std::vector<int> serial(8), parallel(8);
+  for(auto i = 0; i < 8; i++) {
+    Random::Scope rs(Random::Stream::CROSSOVER, 1, i);
+    serial[i] = Random::randomInt(0, 1000000);
+  }
+  std::vector<std::thread> threads;
+  for(auto i = 0; i < 8; i++) {
+    threads.emplace_back([&parallel, i]() {
+	Random::Scope rs(Random::Stream::CROSSOVER, 1, i);
+	parallel[i] = Random::randomInt(0, 1000000);
+      });
+  }
+  for(auto& t : threads) t.join();
+  for(auto i = 0; i < 8; i++) {
+    LONGS_EQUAL(serial[i], parallel[i]);
+  }
+}
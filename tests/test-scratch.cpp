@@ -0,0 +1,48 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <CppUTest/TestHarness.h>
+#include "utils/Scratch.h"
+#include "utils/Directory.h"
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <sys/stat.h>
+
+TEST_GROUP(ScratchTests) {};
+
+TEST(ScratchTests, UniqueFiles) {
+  std::string kept;
+  {
+    Scratch s1(".xml"), s2(".xml");
+    CHECK(s1.path() != s2.path());
+    LONGS_EQUAL(0,s1.path().find(Scratch::directory()+"/"));
+    LONGS_EQUAL(s1.path().size()-4,s1.path().rfind(".xml"));
+    LONGS_EQUAL(0,access(s1.path().c_str(), F_OK));
+    kept = s1.path();
+  }
+  CHECK(access(kept.c_str(), F_OK) != 0);
+}
+
+TEST(ScratchTests, RemoveDirectory) {
+  auto dir = Scratch::directory()+"/tree";
+  mkdir(dir.c_str(),0777);
+  mkdir((dir+"/sub").c_str(),0777);
+  std::ofstream(dir+"/sub/file") << "content";
+  CHECK(Directory::remove(dir));
+  CHECK(access(dir.c_str(), F_OK) != 0);
+  CHECK(!Directory::remove(dir));
+}
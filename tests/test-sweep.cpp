@@ -0,0 +1,62 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <CppUTest/TestHarness.h>
+#include "utils/Sweep.h"
+#include <stdexcept>
+
+namespace {
+  Sweep::Options options() {
+    return {{"-in","scaffold"}, {"-cx","inter"}, {"-dist","cosine"},
+	    {"-fitness","avg"}, {"-g","10"}, {"-m","0.005"},
+	    {"-nb","2,3"}, {"-seed","1,2"}, {"-freq","0"}};
+  }
+
+  const std::vector<std::string> keys =
+    {"-cx","-dist","-fitness","-g","-m","-nb","-seed","-freq"};
+}
+
+TEST_GROUP(SweepTests) {};
+
+TEST(SweepTests, Expand) {
+  auto opt = options();
+  auto configs = Sweep::expand(opt, keys);
+  LONGS_EQUAL(4,configs.size());
+  STRCMP_EQUAL("2",configs[0].at("-nb").c_str());
+  STRCMP_EQUAL("1",configs[0].at("-seed").c_str());
+  STRCMP_EQUAL("2",configs[1].at("-nb").c_str());
+  STRCMP_EQUAL("2",configs[1].at("-seed").c_str());
+  STRCMP_EQUAL("3",configs[3].at("-nb").c_str());
+  STRCMP_EQUAL("2",configs[3].at("-seed").c_str());
+  STRCMP_EQUAL("0",configs[3].at("-freq").c_str());
+}
+
+TEST(SweepTests, Names) {
+  auto opt = options();
+  // Runs differing by a key out of the run name get it in their name
+  auto names = Sweep::names(Sweep::expand(opt, keys), keys);
+  LONGS_EQUAL(4,names.size());
+  STRCMP_EQUAL("scaffold-inter-cosine-avg-10-0.005-2-seed1",names[0].c_str());
+  STRCMP_EQUAL("scaffold-inter-cosine-avg-10-0.005-3-seed2",names[3].c_str());
+
+  opt["-seed"] = "1";
+  opt["-in"] = "data/scaffold";
+  names = Sweep::names(Sweep::expand(opt, keys), keys);
+  STRCMP_EQUAL("data_scaffold-inter-cosine-avg-10-0.005-2",names[0].c_str());
+  STRCMP_EQUAL("data/scaffold-inter-cosine-avg-10-0.005-3",
+	       Sweep::runName(Sweep::expand(opt, keys)[1]).c_str());
+
+  opt["-nb"] = "2,2";
+  CHECK_THROWS(std::runtime_error, Sweep::names(Sweep::expand(opt, keys), keys));
+}
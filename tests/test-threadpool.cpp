@@ -0,0 +1,62 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <CppUTest/TestHarness.h>
+#include "utils/ThreadPool.h"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+TEST_GROUP(ThreadPoolTests) {};
+
+TEST(ThreadPoolTests, ParallelFor) {
+  ThreadPool pool(4);
+  std::vector<int> v(1000, 0);
+  pool.parallelFor(v.size(), [&v](size_t i) { v[i] = i; });
+  for(auto i = 0u; i < v.size(); i++) {
+    LONGS_EQUAL(i,v[i]);
+  }
+
+  // Nested loops run on the same pool
+  std::atomic<int> nb(0);
+  pool.parallelFor(8, [&pool,&nb](size_t) {
+      pool.parallelFor(8, [&nb](size_t) { nb++; });
+    });
+  LONGS_EQUAL(64,nb);
+
+  CHECK_THROWS(std::runtime_error,
+	       pool.parallelFor(10, [](size_t i) {
+		   if(i == 5) throw std::runtime_error("task");
+		 }));
+}
+
+TEST(ThreadPoolTests, ForkedInstanceSize) {
+  ThreadPool::instance();
+  auto pid = fork();
+  if(pid == 0) {
+    // A forked process starts a pool of the size it sets
+    ThreadPool::instanceSize(2);
+    std::atomic<int> nb(0);
+    ThreadPool::instance().parallelFor(10, [&nb](size_t) { nb++; });
+    _exit(ThreadPool::instance().size() == 2 && nb == 10 ? 0 : 1);
+  }
+  CHECK(pid > 0);
+  int status;
+  LONGS_EQUAL(pid,waitpid(pid, &status, 0));
+  CHECK(WIFEXITED(status));
+  LONGS_EQUAL(0,WEXITSTATUS(status));
+  ThreadPool::instanceSize(0);
+}
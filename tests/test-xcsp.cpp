@@ -0,0 +1,110 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <CppUTest/TestHarness.h>
+#include "model/Xcsp.h"
+#include "model/Model.h"
+#include "utils/Random.h"
+#include <sstream>
+
+TEST_GROUP(XcspTests) {};
+
+TEST(XcspTests, CheckAndCutPoints) {
+  Model m("scaffold/c0.chr");
+  auto x = m.getXcsp();
+  CHECK(x->isSupported());
+  LONGS_EQUAL(m.getVal()->size(),x->size());
+  CHECK(x->check(*m.getVal()));
+  CHECK(m.isValid());
+  CHECK(x == Xcsp::load("scaffold/c0.xml"));
+  // Paths of the same file share the network, copies do not
+  CHECK(x == Xcsp::load("./scaffold/../scaffold/c0.xml"));
+  CHECK(x != Xcsp::load("scaffold/c1.xml"));
+
+  CHECK_FALSE(x->cutPoints().empty());
+  for(auto p : x->cutPoints()) {
+    CHECK(p > 0 && p < x->size());
+    for(size_t c = 0; c < x->getConstraints().size(); c++) {
+      auto& scope = x->getConstraints()[c].scope;
+      bool before = false, after = false;
+      for(auto v : scope) {
+	(v < p ? before : after) = true;
+      }
+      CHECK_FALSE(before && after);
+    }
+  }
+}
+
+TEST(XcspTests, Repair) {
+  Model m("scaffold/c0.chr");
+  auto x = m.getXcsp();
+  Random::Scope rs(Random::Stream::REPAIR, 0);
+  Genes g(*m.getVal());
+  auto& domains = x->getDomains();
+  for(size_t i = 0; i < g.size(); i += 7) {
+    g[i] = domains[i].at(Random::randomInt(0, domains[i].count() - 1));
+  }
+  CHECK(x->repair(g));
+  CHECK(x->check(g));
+}
+
+TEST(XcspTests, StreamingReader) {
+  std::istringstream in(
+    "<?xml version=\"1.0\"?>\n"
+    "<!-- generated -->\n"
+    "<instance>\n"
+    " <presentation name='t' format=\"XCSP 2.1\"/>\n"
+    " <domains nbDomains=\"2\">\n"
+    "  <domain name=\"D0\" nbValues=\"3\">1..3</domain>\n"
+    "  <domain name=\"D1\" nbValues=\"2\">0 5</domain>\n"
+    " </domains>\n"
+    " <variables nbVariables=\"3\">\n"
+    "  <variable name=\"X\" domain=\"D0\"/>\n"
+    "  <variable name=\"Y\" domain=\"D0\"/>\n"
+    "  <variable name=\"Z\" domain=\"D1\"/>\n"
+    " </variables>\n"
+    " <predicates nbPredicates=\"1\">\n"
+    "  <predicate name=\"P0\">\n"
+    "   <parameters>int A int B</parameters>\n"
+    "   <expression><functional><![CDATA[lt(A,B)]]></functional></expression>\n"
+    "  </predicate>\n"
+    " </predicates>\n"
+    " <constraints nbConstraints=\"1\">\n"
+    "  <constraint name=\"C0\" arity=\"2\" scope=\"X Y\" reference=\"P0\">\n"
+    "   <parameters>X Y</parameters>\n"
+    "  </constraint>\n"
+    " </constraints>\n"
+    "</instance>\n");
+  Xcsp x(in);
+  CHECK(x.isSupported());
+  LONGS_EQUAL(3,x.size());
+  STRCMP_EQUAL("Z",x.getVariables()[2].c_str());
+  CHECK(x.getDomains()[2].include(5));
+  CHECK_FALSE(x.getDomains()[2].include(3));
+  LONGS_EQUAL(1,x.getConstraints().size());
+  CHECK(x.check({1,2,0}));
+  CHECK_FALSE(x.check({2,2,0}));
+
+  std::istringstream bad("<instance><domains></instance>");
+  CHECK_FALSE(Xcsp(bad).isSupported());
+
+  // Documents that are not an instance are not empty networks
+  for(auto text : {"", "<?xml version=\"1.0\"?>\n", "<csp></csp>",
+	"<instance/><instance/>", "<instance>"}) {
+    std::istringstream other(text);
+    CHECK_FALSE(Xcsp(other).isValid());
+  }
+  std::istringstream empty("<instance/>");
+  CHECK(Xcsp(empty).isValid());
+}
@@ -0,0 +1,375 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * mdea-bench times the hot kernels of MDEA (distances, dominance,
+ * sorting, crowding, clustering, mutation, crossover, matrix reductions
+ * and serialization) on synthetic populations of increasing sizes. Each
+ * kernel and size gives a line of a CSV file (nanoseconds per call), so
+ * that two versions can be compared.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "model/GAChromosom.h"
+#include "model/GenFile.h"
+#include "model/Matrix.h"
+#include "model/Model.h"
+#include "model/NSGAII.h"
+#include "model/Population.h"
+#include "utils/CommandLine.h"
+#include "utils/Format.h"
+#include "utils/Random.h"
+#include "utils/Scratch.h"
+
+#ifndef BENCH_FLAGS
+#define BENCH_FLAGS "unknown flags"
+#endif
+
+namespace {
+  typedef std::chrono::steady_clock Clock;
+
+  /* Compiler and flags of the build, a column of results */
+  const char* build = __VERSION__ " " BENCH_FLAGS;
+
+  /* Results are accumulated here so that calls are not optimized out */
+  volatile double sink = 0;
+
+  /* Timing of a kernel for a size */
+  struct Result {
+    std::string kernel;
+    size_t individuals;
+    size_t models;
+    size_t genes;
+    size_t calls;
+    double min;
+    double median;
+    double mean;
+  };
+
+  /* A synthetic configuration (0 if it does not apply to the kernel) */
+  struct Size {
+    size_t individuals;
+    size_t models;
+    size_t genes;
+  };
+
+  class Bench {
+    std::string filter;
+    double budget;
+    std::vector<Result> results;
+  public:
+    Bench(const std::string& filter, double budget):
+      filter(filter), budget(budget) {}
+
+    /* Time f, called in batches of at least 10 µs, during the budget
+       (at least 5 batches, unless they last 10 budgets) */
+    void run(const std::string& kernel, const Size& s,
+	     const std::function<void()>& f) {
+      if(filter != "" && kernel.find(filter) == std::string::npos) return;
+      auto elapsed = [](Clock::time_point t) {
+	return std::chrono::duration<double,std::nano>(Clock::now()-t).count();
+      };
+      auto t = Clock::now();
+      f();
+      size_t batch = 1;
+      while(elapsed(t) < 1e4 && batch < (1u << 20)) {
+	batch *= 2;
+	t = Clock::now();
+	for(auto i = 0u; i < batch; i++) f();
+      }
+      std::vector<double> samples;
+      auto start = Clock::now();
+      while(samples.empty() || elapsed(start) < budget*1e6 ||
+	    (samples.size() < 5 && elapsed(start) < 10*budget*1e6)) {
+	auto t = Clock::now();
+	for(auto i = 0u; i < batch; i++) f();
+	samples.push_back(elapsed(t)/batch);
+      }
+      std::sort(samples.begin(), samples.end());
+      double sum = 0;
+      for(auto v : samples) sum += v;
+      results.push_back({kernel, s.individuals, s.models, s.genes,
+	    samples.size()*batch, samples.front(),
+	    samples[samples.size()/2], sum/samples.size()});
+      auto& r = results.back();
+      std::cerr << std::left << std::setw(22) << kernel << std::right
+		<< " ind=" << std::setw(4) << s.individuals
+		<< " nb=" << std::setw(2) << s.models
+		<< " genes=" << std::setw(5) << s.genes
+		<< std::setw(14) << std::fixed << std::setprecision(1)
+		<< r.median << " ns" << std::endl;
+    }
+
+    void write(std::ostream& os) const {
+      os << "kernel,individuals,models,genes,calls,min_ns,median_ns,mean_ns,build\n";
+      for(auto& r : results) {
+	os << r.kernel << "," << r.individuals << "," << r.models << ","
+	   << r.genes << "," << r.calls << "," << std::fixed
+	   << std::setprecision(1) << r.min << "," << r.median << ","
+	   << r.mean << ",\"" << build << "\"\n";
+      }
+    }
+  };
+
+  std::vector<size_t> sizes(const std::string& s, const std::string& init) {
+    std::vector<size_t> ret;
+    std::stringstream split(s != "" ? s : init);
+    std::string v;
+    while(std::getline(split,v,',')) {
+      ret.push_back(std::stoul(v));
+    }
+    return ret;
+  }
+
+  /* Domains of synthetic genes */
+  DomainsPtr domains(size_t genes) {
+    auto ret = std::make_shared<Domains>(genes);
+    for(auto& d : *ret) {
+      d.add(Interval<int>(0,31));
+    }
+    return ret;
+  }
+
+  /* Models with random genes, and the metadata of a real model (whose
+     constraint network does not match, as for unsupported networks) */
+  std::vector<Model> corpus(const Model& tmpl, size_t nb, size_t genes) {
+    auto d = domains(genes);
+    std::vector<Model> ret;
+    for(auto i = 0u; i < nb; i++) {
+      auto g = std::make_shared<Genes>(genes);
+      for(auto& v : *g) {
+	v = Random::randomInt(0,31);
+      }
+      ret.emplace_back(tmpl, g, d);
+    }
+    return ret;
+  }
+
+  /* Random distances between the models of an individual */
+  Objectives objectives(size_t models) {
+    Objectives ret(models);
+    for(auto k = 0; k < 3; k++) {
+      for(auto i = 0u; i < models; i++) {
+	for(auto j = i+1; j < models; j++) {
+	  ret.set(static_cast<Objectives::Kind>(k), i, j,
+		  Random::randomFloat(0.0,1.0));
+	}
+      }
+    }
+    return ret;
+  }
+
+  /* Population of random scored individuals */
+  Population* population(const Model& tmpl, const Size& s) {
+    Chromosom::setNbModels(s.models);
+    auto pop = new Population(corpus(tmpl, s.individuals*s.models, s.genes));
+    for(auto i = 0; i < pop->size(); i++) {
+      static_cast<GAChromosom&>(pop->individual(i)).score(objectives(s.models));
+    }
+    return pop;
+  }
+
+  Matrix matrix(size_t n) {
+    Matrix ret(n);
+    for(auto i = 0u; i < n; i++) {
+      for(auto j = i+1; j < n; j++) {
+	ret.set(i, j, Random::randomFloat(0.0,1.0));
+      }
+    }
+    return ret;
+  }
+
+  /* Distances and genetic operators, by gene length */
+  void benchModels(Bench& b, const Model& tmpl, const std::vector<size_t>& lengths) {
+    for(auto genes : lengths) {
+      Size s = {0, 2, genes};
+      auto c = corpus(tmpl, 2, genes);
+      b.run("cosine", s, [&]() {
+	  sink = sink + Model::cosineDistance(c[0], c[1]);
+	});
+      b.run("levenshtein", s, [&]() {
+	  sink = sink + Model::levenshteinDistance(c[0], c[1]);
+	});
+      Chromosom::setNbModels(2);
+      Population pop(corpus(tmpl, 4, genes));
+      auto& dad = static_cast<GAChromosom&>(pop.individual(0));
+      auto& mom = static_cast<GAChromosom&>(pop.individual(1));
+      b.run("mutate", s, [&]() {
+	  GAChromosom child(dad);
+	  sink = sink + child.Chromosom::mutate(0.005);
+	});
+      GAChromosom sis, bro;
+      b.run("crossover-inter", s, [&]() {
+	  sink = sink + GAChromosom::onePointCrossover(dad, mom, &sis, &bro);
+	});
+      b.run("crossover-intra", s, [&]() {
+	  sink = sink + GAChromosom::onePointIntraCrossover(dad, mom, &sis, &bro);
+	});
+      b.run("model-to-string", s, [&]() {
+	  sink = sink + c[0].to_string().size();
+	});
+    }
+  }
+
+  /* Dominance of objectives and matrix reductions, by number of
+     models */
+  void benchMatrices(Bench& b, const Model& tmpl, const std::vector<size_t>& counts) {
+    auto fitness = NSGAII::fitness;
+    // The algorithm needs a population, dominate does not use it
+    std::unique_ptr<Population> pop(population(tmpl, Size{2, 2, 8}));
+    NSGAII ga(*pop);
+    for(auto n : counts) {
+      Size s = {0, n, 0};
+      auto o1 = objectives(n), o2 = objectives(n);
+      NSGAII::fitness = NSGAII::Fitness::DIST;
+      b.run("dominate-dist", s, [&]() {
+	  sink = sink + ga.dominate(o1, o2, Objectives::COSINE);
+	});
+      NSGAII::fitness = NSGAII::Fitness::AVG | NSGAII::Fitness::MIN;
+      b.run("dominate-minavg", s, [&]() {
+	  sink = sink + ga.dominate(o1, o2, Objectives::COSINE);
+	});
+      auto m1 = matrix(n), m2 = matrix(n);
+      b.run("matrix-average", s, [&]() {
+	  sink = sink + m1.average();
+	});
+      b.run("matrix-min", s, [&]() {
+	  sink = sink + m1.min();
+	});
+      b.run("matrix-line-average", s, [&]() {
+	  sink = sink + m1.lineAverage(n-1);
+	});
+      b.run("matrix-compare", s, [&]() {
+	  sink = sink + Matrix::compare(m1, m2);
+	});
+    }
+    NSGAII::fitness = fitness;
+  }
+
+  /* Selection and outputs, by population size */
+  void benchPopulations(Bench& b, const Model& tmpl, const std::vector<size_t>& counts,
+		   size_t genes) {
+    auto fitness = NSGAII::fitness;
+    NSGAII::fitness = NSGAII::Fitness::DIST;
+    for(auto n : counts) {
+      Size s = {n, 2, genes};
+      std::unique_ptr<Population> pop(population(tmpl, s));
+      NSGAII ga(*pop);
+      b.run("sort", s, [&]() {
+	  sink = sink + ga.fastNonDominatedSort()->size();
+	});
+      std::vector<int> all(n);
+      for(auto i = 0u; i < n; i++) all[i] = i;
+      b.run("crowding", s, [&]() {
+	  sink = sink + ga.crowdingDistanceAssignment(all).size();
+	});
+      // Offspring and parents are clustered into the population size
+      Size sc = {2*n, 2, genes};
+      std::unique_ptr<Population> popr(population(tmpl, sc));
+      auto res = std::make_shared<Matrix>(matrix(2*n));
+      // (its progress output is dropped)
+      auto out = std::cout.rdbuf(nullptr);
+      b.run("clustering", sc, [&]() {
+	  Population p;
+	  ga.clustering(popr.get(), &p, n, res);
+	  sink = sink + p.size();
+	});
+      std::cout.rdbuf(out);
+      std::cout.clear();
+      auto& c = static_cast<GAChromosom&>(pop->individual(0));
+      b.run("chromosom-to-string", s, [&]() {
+	  sink = sink + c.to_string().size();
+	});
+      auto scores = matrix(n);
+      b.run("matrix-csv", Size{n, 0, 0}, [&]() {
+	  sink = sink + scores.to_csv_string().size();
+	});
+      Scratch file;
+      b.run("genfile-write", s, [&]() {
+	  GenFile::write(file.path(), 0, *pop);
+	});
+      b.run("genfile-read", s, [&]() {
+	  GenFile g(file.path());
+	  sink = sink + g.size();
+	});
+      b.run("genfile-to-string", s, [&]() {
+	  GenFile g(file.path());
+	  sink = sink + g.to_string().size();
+	});
+    }
+    NSGAII::fitness = fitness;
+  }
+
+  /* Number formatting, per number */
+  void benchNumbers(Bench& b) {
+    std::vector<double> reals(1024);
+    for(auto& v : reals) v = Random::randomFloat(-1000.0,1000.0);
+    std::string s;
+    size_t k = 0;
+    b.run("format-fixed", Size{0, 0, 0}, [&]() {
+	if(s.size() > 65536) s.clear();
+	Format::appendFixed(s, reals[k++ % reals.size()]);
+      });
+    b.run("to-string-fixed", Size{0, 0, 0}, [&]() {
+	if(s.size() > 65536) s.clear();
+	s += std::to_string(reals[k++ % reals.size()]);
+      });
+    b.run("format-integer", Size{0, 0, 0}, [&]() {
+	if(s.size() > 65536) s.clear();
+	Format::appendInteger(s, static_cast<long long>(reals[k++ % reals.size()]));
+      });
+  }
+}
+
+int main(int argc, char** argv) {
+  CommandLine cl("mdea-bench");
+  cl.addOption("-out","-out <CSV result file, default: bench.csv>",false);
+  cl.addOption("-filter","-filter <only kernels whose name contains it>",false);
+  cl.addOption("-time","-time <milliseconds per kernel and size, default: 200>",false);
+  cl.addOption("-individuals","-individuals <population sizes, default: 32,64,128>",false);
+  cl.addOption("-genes","-genes <gene vector lengths, default: 64,256,1024>",false);
+  cl.addOption("-models","-models <numbers of models, default: 2,3,5,8>",false);
+  cl.addOption("-template","-template <model providing metadata, default: scaffold/c0.chr>",false);
+  auto opt = cl.parse(argc,argv);
+
+  auto out = (opt->at("-out") != "") ? opt->at("-out") : "bench.csv";
+  auto budget = (opt->at("-time") != "") ? std::stod(opt->at("-time")) : 200.;
+  auto tmpl = Model((opt->at("-template") != "") ? opt->at("-template") : "scaffold/c0.chr");
+  auto individuals = sizes(opt->at("-individuals"), "32,64,128");
+  auto genes = sizes(opt->at("-genes"), "64,256,1024");
+  auto models = sizes(opt->at("-models"), "2,3,5,8");
+
+  // Synthetic data do not depend on the run
+  Random::seed(1);
+  Bench b(opt->at("-filter"), budget);
+  benchModels(b, tmpl, genes);
+  benchMatrices(b, tmpl, models);
+  benchPopulations(b, tmpl, individuals, genes[genes.size()/2]);
+  benchNumbers(b);
+
+  std::ofstream of(out);
+  b.write(of);
+  std::cout << "Results written to " << out << std::endl;
+  delete opt;
+  return 0;
+}
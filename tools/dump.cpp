@@ -0,0 +1,40 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * mdea-dump prints the text view of binary generation files
+ * (output/genN), as written by former versions of MDEA.
+ */
+
+#include <iostream>
+#include <stdexcept>
+#include "model/GenFile.h"
+
+int main(int argc, char** argv) {
+  if(argc < 2) {
+    std::cerr << "Syntax : mdea-dump <generation file>..." << std::endl;
+    return 1;
+  }
+  auto ret = 0;
+  for(auto i = 1; i < argc; i++) {
+    try {
+      GenFile file(argv[i]);
+      std::cout << file.to_string();
+    } catch(const std::exception& e) {
+      std::cerr << e.what() << std::endl;
+      ret = 1;
+    }
+  }
+  return ret;
+}
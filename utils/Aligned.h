@@ -0,0 +1,74 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * \file Aligned.h
+ * \brief AlignedAllocator class header.
+ * \author Florian Galinier
+ * \version 0.1
+ * \date 19/10/26
+ *
+ * Allocator of aligned buffers (for vectorized loops).
+ *
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/**
+ * \class AlignedAllocator
+ * \brief Standard allocator whose buffers start on an Alignment
+ * boundary.
+ *
+ * \author Florian Galinier
+ */
+template <typename T, size_t Alignment = 32>
+class AlignedAllocator {
+ public:
+  typedef T value_type;
+  template <typename U>
+  struct rebind {
+    typedef AlignedAllocator<U,Alignment> other;
+  };
+  AlignedAllocator() noexcept {}
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U,Alignment>&) noexcept {}
+  /**
+   * Allocate an aligned buffer.
+   * \param n The number of elements.
+   * \return The buffer.
+   * \throw std::bad_alloc if the buffer can not be allocated.
+   */
+  T* allocate(size_t n) {
+    void* p = nullptr;
+    auto size = n ? n*sizeof(T) : Alignment;
+    if(posix_memalign(&p, Alignment, size))
+      throw std::bad_alloc();
+    return static_cast<T*>(p);
+  }
+  /**
+   * Free a buffer.
+   * \param p The buffer.
+   */
+  void deallocate(T* p, size_t) noexcept {
+    free(p);
+  }
+  template <typename U>
+  bool operator==(const AlignedAllocator<U,Alignment>&) const noexcept { return true; }
+  template <typename U>
+  bool operator!=(const AlignedAllocator<U,Alignment>&) const noexcept { return false; }
+};
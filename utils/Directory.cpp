@@ -14,6 +14,8 @@
 
 #include "Directory.h"
 #include <iostream>
+#include <cstdio>
+#include <ftw.h>
 
 Directory::Directory(std::string path): path(opendir(path.c_str())) {}
 
@@ -53,3 +55,10 @@ std::shared_ptr<std::vector<std::string>> Directory::getFiles(std::string ext) c
   
   return ret;
 }
+
+bool Directory::remove(const std::string& path) {
+  auto failed = nftw(path.c_str(), [](const char* p, const struct stat*, int, struct FTW*) {
+      return ::remove(p);
+    }, 16, FTW_DEPTH | FTW_PHYS);
+  return !failed;
+}
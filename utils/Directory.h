@@ -62,4 +62,11 @@ class Directory {
    * \return A vector with files path.
    */
   virtual std::shared_ptr<std::vector<std::string>> getFiles(std::string ext = "") const;
+  /**
+   * Remove a file or a directory and its content (symbolic links are
+   * removed, not followed).
+   * \param path The path to remove.
+   * \return true iff everything was removed.
+   */
+  static bool remove(const std::string& path);
 };
@@ -0,0 +1,93 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Format.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+namespace {
+  const char digitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+  /* Write the digits of v backward, ending at end, return the start */
+  char* digits(char* end, unsigned long long v) {
+    while(v >= 100) {
+      auto d = (v % 100)*2;
+      v /= 100;
+      *--end = digitPairs[d+1];
+      *--end = digitPairs[d];
+    }
+    if(v >= 10) {
+      *--end = digitPairs[v*2+1];
+      *--end = digitPairs[v*2];
+    }
+    else *--end = '0'+v;
+    return end;
+  }
+}
+
+char* Format::integer(char* p, long long v) {
+  char tmp[integerSize];
+  auto end = tmp+integerSize;
+  unsigned long long u = v;
+  if(v < 0) {
+    *p++ = '-';
+    u = 0ull - u;
+  }
+  auto start = digits(end, u);
+  std::memcpy(p, start, end-start);
+  return p+(end-start);
+}
+
+void Format::appendInteger(std::string& s, long long v) {
+  char buffer[integerSize+1];
+  s.append(buffer, integer(buffer, v));
+}
+
+void Format::appendFixed(std::string& s, double v) {
+  // v×10^6 is rounded once: its nearest integer is the one of the exact
+  // value unless it lies within an ulp of a half, where printf is used
+  auto a = std::fabs(v);
+  auto x = a*1e6;
+  if(std::isfinite(v) && x < 1e15) {
+    auto r = std::floor(x);
+    auto frac = x-r;
+    if(std::fabs(frac-0.5) > 2*std::numeric_limits<double>::epsilon()*(x+1)) {
+      auto u = static_cast<unsigned long long>(r) + (frac > 0.5);
+      char buffer[integerSize+9];
+      auto end = buffer+sizeof(buffer);
+      auto p = digits(end, u % 1000000);
+      while(p > end-6) *--p = '0';
+      *--p = '.';
+      p = digits(p, u / 1000000);
+      if(std::signbit(v)) *--p = '-';
+      s.append(p, end);
+      return;
+    }
+  }
+  char buffer[std::numeric_limits<double>::max_exponent10+20];
+  auto n = std::snprintf(buffer, sizeof(buffer), "%f", v);
+  s.append(buffer, n);
+}
@@ -0,0 +1,64 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file Format.h
+ * \brief Format class header.
+ * \author Florian Galinier
+ * \version 0.1
+ * \date 19/10/26
+ *
+ * Number to text conversion for outputs.
+ *
+ */
+
+#pragma once
+#include <string>
+
+/**
+ * \class Format
+ * \brief Append numbers to a string without temporary strings or
+ * streams.
+ *
+ * Texts are those of std::to_string, so outputs do not change.
+ *
+ * \author Florian Galinier
+ */
+class Format {
+ public:
+  /**
+   * Largest number of characters of an integer.
+   */
+  static const size_t integerSize = 20;
+  /**
+   * Write an integer.
+   * \param p The buffer, of at least integerSize characters.
+   * \param v The integer.
+   * \return The end of the written text.
+   */
+  static char* integer(char* p, long long v);
+  /**
+   * Append an integer to a string (text of std::to_string).
+   * \param s The string.
+   * \param v The integer.
+   */
+  static void appendInteger(std::string& s, long long v);
+  /**
+   * Append a real to a string, with 6 decimals (text of
+   * std::to_string).
+   * \param s The string.
+   * \param v The real.
+   */
+  static void appendFixed(std::string& s, double v);
+};
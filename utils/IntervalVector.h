@@ -85,6 +85,31 @@ class IntervalVector {
     }
     return false;
   }
+  /**
+   * Return the number of values included in the interval vector.
+   * \return The number of values.
+   */
+  virtual size_t count() const {
+    size_t nb = 0;
+    for(auto& i : intervals) {
+      nb += static_cast<size_t>(i.ubound() - i.lbound()) + 1;
+    }
+    return nb;
+  }
+  /**
+   * Return the k-th value (in increasing order) of the interval vector.
+   * \param k The rank of the value (0 <= k < count()).
+   * \return The k-th value.
+   */
+  virtual T at(size_t k) const {
+    for(auto& i : intervals) {
+      auto nb = static_cast<size_t>(i.ubound() - i.lbound()) + 1;
+      if(k < nb)
+	return i.lbound() + static_cast<T>(k);
+      k -= nb;
+    }
+    throw std::out_of_range("Try to access to unknown "+std::to_string(k)+"th value of IntervalVector.");
+  }
   /**
    * Add an interval to the vector
    * \param i The new interval to add
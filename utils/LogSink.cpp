@@ -0,0 +1,234 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LogSink.h"
+#include <chrono>
+#include <cstdlib>
+#include <set>
+#include <pthread.h>
+#include <unistd.h>
+#include <algorithm>
+
+namespace {
+  /* Buffers are collected at least this often */
+  const auto period = std::chrono::milliseconds(100);
+  /* A thread buffer larger than this wakes the writer */
+  const size_t threshold = 1 << 20;
+  /* Handles kept open between two writes */
+  const size_t maxHandles = 64;
+}
+
+/**
+ * \brief Buffer of the calling thread, registered while the thread lives.
+ */
+struct ThreadBuffer {
+  LogSink::Buffer buffer;
+  LogSink* sink;
+  ThreadBuffer(): sink(&LogSink::instance()) {
+    sink->attach(&buffer);
+  }
+  ~ThreadBuffer() {
+    sink->detach(&buffer);
+  }
+};
+
+/* Constructors */
+
+LogSink::LogSink(): sequence(0), truncations(0), requested(0), done(0),
+		    stopping(false) {
+  writer = std::thread(&LogSink::run, this);
+}
+
+LogSink::~LogSink() {
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    stopping = true;
+    requested++;
+  }
+  wake.notify_one();
+  writer.join();
+  for(auto& h : handles) {
+    fclose(h.second);
+  }
+}
+
+namespace {
+  /* Sink locked while forking */
+  LogSink* forking = nullptr;
+}
+
+LogSink& LogSink::instance() {
+  // Never destroyed: threads that logged may end after static
+  // destructors (workers of a pool built first), pending chunks are
+  // written at exit instead
+  static auto sink = new LogSink();
+  static const pid_t owner = getpid();
+  static std::once_flag handlers;
+  std::call_once(handlers, [] {
+      pthread_atfork(&LogSink::prepareFork, &LogSink::afterFork, &LogSink::afterFork);
+      std::atexit([] { instance().flush(); });
+    });
+  if(getpid() == owner) return *sink;
+  static std::mutex forkLock;
+  static LogSink* forked = nullptr;
+  static pid_t forkedPid = 0;
+  std::lock_guard<std::mutex> guard(forkLock);
+  if(forkedPid != getpid()) {
+    forked = new LogSink();
+    forkedPid = getpid();
+  }
+  return *forked;
+}
+
+void LogSink::prepareFork() {
+  forking = &instance();
+  forking->lock.lock();
+}
+
+void LogSink::afterFork() {
+  forking->lock.unlock();
+}
+
+/* Thread buffers */
+
+void LogSink::attach(Buffer* b) {
+  std::lock_guard<std::mutex> guard(lock);
+  buffers.push_back(b);
+}
+
+void LogSink::detach(Buffer* b) {
+  std::lock_guard<std::mutex> guard(lock);
+  std::lock_guard<std::mutex> bguard(b->lock);
+  for(auto& c : b->chunks) {
+    orphans.push_back(std::move(c));
+  }
+  for(auto it = buffers.begin(); it != buffers.end(); it++) {
+    if(*it == b) {
+      buffers.erase(it);
+      break;
+    }
+  }
+}
+
+void LogSink::submit(const std::string& file, std::string&& data,
+		     bool truncate) {
+  thread_local ThreadBuffer tb;
+  auto& b = tb.buffer;
+  if(tb.sink != this) {
+    // First write of this thread since fork: chunks pending in the
+    // parent are the parent's
+    b.chunks.clear();
+    b.bytes = 0;
+    tb.sink = this;
+    attach(&b);
+  }
+  auto full = false;
+  auto epoch = truncate ? ++truncations : truncations.load();
+  {
+    std::lock_guard<std::mutex> guard(b.lock);
+    b.bytes += data.size();
+    // Consecutive appends to the same file are merged, unless a file
+    // was truncated in between (the order of both would be lost)
+    if(!truncate && !b.chunks.empty() && b.chunks.back().file == file &&
+       b.chunks.back().epoch == epoch) {
+      b.chunks.back().data += data;
+    }
+    else {
+      b.chunks.push_back({file, truncate, std::move(data), sequence++, epoch});
+    }
+    full = b.bytes > threshold;
+  }
+  if(full) {
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      requested++;
+    }
+    wake.notify_one();
+  }
+}
+
+std::vector<LogSink::Chunk> LogSink::collect() {
+  auto chunks = std::move(orphans);
+  orphans.clear();
+  for(auto b : buffers) {
+    std::lock_guard<std::mutex> guard(b->lock);
+    for(auto& c : b->chunks) {
+      chunks.push_back(std::move(c));
+    }
+    b->chunks.clear();
+    b->bytes = 0;
+  }
+  std::sort(chunks.begin(), chunks.end(),
+	    [](const Chunk& a, const Chunk& b) { return a.seq < b.seq; });
+  return chunks;
+}
+
+/* Writer */
+
+void LogSink::run() {
+  std::unique_lock<std::mutex> l(lock);
+  while(true) {
+    wake.wait_for(l, period, [this] { return stopping || requested != done; });
+    auto target = requested;
+    auto stop = stopping;
+    auto chunks = collect();
+    l.unlock();
+    output(chunks);
+    l.lock();
+    done = target;
+    written.notify_all();
+    if(stop) break;
+  }
+}
+
+void LogSink::output(std::vector<Chunk>& chunks) {
+  std::set<FILE*> touched;
+  for(auto& c : chunks) {
+    auto& f = handles[c.file];
+    if(c.truncate && f) {
+      touched.erase(f);
+      fclose(f);
+      f = nullptr;
+    }
+    if(!f) f = fopen(c.file.c_str(), c.truncate ? "w" : "a");
+    if(!f) {
+      handles.erase(c.file);
+      continue;
+    }
+    fwrite(c.data.data(), 1, c.data.size(), f);
+    touched.insert(f);
+  }
+  for(auto f : touched) {
+    fflush(f);
+  }
+  // Idle handles are closed when too many files were opened
+  if(handles.size() > maxHandles) {
+    for(auto it = handles.begin(); it != handles.end();) {
+      if(!touched.count(it->second)) {
+	fclose(it->second);
+	it = handles.erase(it);
+      }
+      else it++;
+    }
+  }
+}
+
+/* Synchronization */
+
+void LogSink::flush() {
+  std::unique_lock<std::mutex> l(lock);
+  auto ticket = ++requested;
+  wake.notify_one();
+  written.wait(l, [this,ticket] { return done >= ticket; });
+}
@@ -0,0 +1,143 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file LogSink.h
+ * \brief LogSink class header.
+ * \author Florian Galinier
+ * \version 0.1
+ * \date 19/10/26
+ *
+ * Background writer shared by all loggers.
+ *
+ */
+
+#pragma once
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+
+/**
+ * \class LogSink
+ * \brief Asynchronous sink for log files.
+ *
+ * Writers append to a buffer owned by their thread; a background
+ * thread periodically collects every buffer and writes it with one
+ * open handle per file. Chunks are written in submission order.
+ *
+ * \author Florian Galinier
+ */
+class LogSink {
+ private:
+  /**
+   * \brief Data to write in a file.
+   * If truncate is set, the file is emptied before writing. Chunks are
+   * written by increasing seq, the submission order across threads.
+   */
+  struct Chunk {
+    std::string file;
+    bool truncate;
+    std::string data;
+    unsigned long seq;
+    unsigned long epoch;
+  };
+  /**
+   * \brief Pending chunks of a thread.
+   */
+  struct Buffer {
+    std::mutex lock;
+    std::vector<Chunk> chunks;
+    size_t bytes = 0;
+  };
+  friend struct ThreadBuffer;
+
+  std::mutex lock;
+  std::condition_variable wake;
+  std::condition_variable written;
+  std::vector<Buffer*> buffers;
+  std::vector<Chunk> orphans;
+  std::map<std::string,FILE*> handles;
+  std::atomic<unsigned long> sequence;
+  std::atomic<unsigned long> truncations;
+  unsigned long requested;
+  unsigned long done;
+  bool stopping;
+  std::thread writer;
+
+  LogSink();
+  /**
+   * Background thread loop.
+   */
+  void run();
+  /**
+   * Take every pending chunk (the sink lock must be held).
+   * \return The pending chunks, in submission order.
+   */
+  std::vector<Chunk> collect();
+  /**
+   * Write chunks to their files.
+   * \param chunks The chunks to write.
+   */
+  void output(std::vector<Chunk>& chunks);
+  /**
+   * Register a thread buffer.
+   * \param b The buffer.
+   */
+  void attach(Buffer* b);
+  /**
+   * Unregister a thread buffer, keeping its pending chunks.
+   * \param b The buffer.
+   */
+  void detach(Buffer* b);
+  /**
+   * fork handlers: the sink lock is held across fork, so that the
+   * copy of the sink in the child is consistent.
+   */
+  static void prepareFork();
+  static void afterFork();
+ public:
+  LogSink(const LogSink&) = delete;
+  LogSink& operator=(const LogSink&) = delete;
+  /**
+   * Write every pending chunk and stop the background thread.
+   */
+  virtual ~LogSink() noexcept;
+  /**
+   * Return the sink of the process. It is never destroyed, and what is
+   * queued is written when the process exits. The background thread
+   * does not survive fork: a forked process gets a new sink, and must
+   * flush it and leave with _exit (the copy of the parent sink can not
+   * be destroyed). Chunks pending at fork are written by the parent
+   * only.
+   * \return The sink.
+   */
+  static LogSink& instance();
+  /**
+   * Queue data to write in a file, from the calling thread.
+   * \param file The file path.
+   * \param data The data to write.
+   * \param truncate true if the file must be emptied first.
+   */
+  void submit(const std::string& file, std::string&& data,
+	      bool truncate = false);
+  /**
+   * Block until everything queued before the call is written.
+   */
+  void flush();
+};
@@ -13,16 +13,25 @@
  */
 
 #include "Logger.h"
+#include "LogSink.h"
 
 Logger::Logger(std::string fileName, std::ios_base::openmode mode):
-  file(fileName,mode)  {}
+  fileName(fileName), truncate(!(mode & std::ios_base::app)) {}
 
 Logger::~Logger() {
-  file.close();
+  LogSink::instance().submit(fileName, std::move(buffer), truncate);
 }
 
 void Logger::write(std::string s) {
-  file << s;
+  buffer += s;
+}
+
+void Logger::flush() {
+  LogSink::instance().submit(fileName, std::move(buffer), truncate);
+  buffer.clear();
+  // Later writes are appended to what was just submitted
+  truncate = false;
+  LogSink::instance().flush();
 }
 
 Logger& Logger::operator<<(const std::string& s) {
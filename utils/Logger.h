@@ -25,7 +25,6 @@
 
 #pragma once
 #include <string>
-#include <fstream>
 #include <ios>
 
 /**
@@ -33,12 +32,16 @@
  * \brief Class that allow to log information in a file.
  *
  * This class provide an interface to write informations in a file,
- * like population state or rejected mutation rate.
+ * like population state or rejected mutation rate. Written data is
+ * buffered and handed to the LogSink on destruction, so the file is
+ * updated asynchronously (see flush).
  *
  * \author Florian Galinier
  */
 class Logger {
-  std::ofstream file;
+  std::string fileName;
+  std::string buffer;
+  bool truncate;
  public:
   /**
    * Create a new log file
@@ -56,6 +59,11 @@ class Logger {
    * \param s The string to write
    */
   virtual void write(std::string s);
+  /**
+   * Block until everything written by this logger (and before) is in
+   * the file.
+   */
+  virtual void flush();
   /**
    * Overloaded operator to use log as a stream
    * \param t the object to write
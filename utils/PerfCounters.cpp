@@ -0,0 +1,238 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PerfCounters.h"
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+#include <dirent.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+namespace {
+  /* Counters of a thread: file descriptors of the group (leader first,
+     -1 for events not counted) */
+  struct Group {
+    std::array<int,PerfCounters::events> fds;
+  };
+
+  struct State {
+    std::mutex lock;
+    pid_t pid = 0;
+    std::array<bool,PerfCounters::events> counted{};
+    std::map<pid_t,Group> threads;
+    /* Final counts of threads that have ended */
+    PerfCounters::Values ended{};
+    std::string error;
+  };
+
+  State& state() {
+    static State s;
+    return s;
+  }
+
+#ifdef __linux__
+  const std::array<unsigned long long,PerfCounters::events> configs = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+  };
+
+  int openEvent(unsigned long long config, pid_t tid, int leader) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED
+      | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return syscall(SYS_perf_event_open, &attr, tid, -1, leader, PERF_FLAG_FD_CLOEXEC);
+  }
+
+  /* Open the events of s.counted for a thread, or every event that can
+     be if first is true (the lock must be held) */
+  bool openGroup(State& s, pid_t tid, bool first) {
+    Group g;
+    g.fds.fill(-1);
+    auto leader = -1;
+    for(auto e = 0u; e < PerfCounters::events; e++) {
+      if(!first && !s.counted[e]) continue;
+      g.fds[e] = openEvent(configs[e], tid, leader);
+      if(g.fds[e] < 0 && first) {
+	s.error = std::string(PerfCounters::name(static_cast<PerfCounters::Event>(e)))
+	  + ": " + std::strerror(errno);
+	continue;
+      }
+      if(g.fds[e] < 0) {
+	// The thread has ended, or counters are exhausted
+	for(auto fd : g.fds) {
+	  if(fd >= 0) close(fd);
+	}
+	return false;
+      }
+      if(first) s.counted[e] = true;
+      if(leader < 0) leader = g.fds[e];
+    }
+    if(leader < 0) return false;
+    s.threads[tid] = g;
+    return true;
+  }
+
+  /* Open the counters of threads started since the last call, return
+     the threads alive (the lock must be held) */
+  std::set<pid_t> attach(State& s) {
+    std::set<pid_t> alive;
+    auto dir = opendir("/proc/self/task");
+    if(!dir) return alive;
+    while(auto entry = readdir(dir)) {
+      if(entry->d_name[0] == '.') continue;
+      auto tid = static_cast<pid_t>(std::atoi(entry->d_name));
+      alive.insert(tid);
+      if(!s.threads.count(tid))
+	openGroup(s, tid, false);
+    }
+    closedir(dir);
+    return alive;
+  }
+#endif
+
+  void closeAll(State& s) {
+    for(auto& t : s.threads) {
+      for(auto fd : t.second.fds) {
+	if(fd >= 0) close(fd);
+      }
+    }
+    s.threads.clear();
+    s.ended.fill(0);
+    s.counted.fill(false);
+    s.pid = 0;
+  }
+}
+
+const char* PerfCounters::name(Event e) {
+  switch(e) {
+  case CYCLES: return "cycles";
+  case INSTRUCTIONS: return "instructions";
+  case CACHE_MISSES: return "cache_misses";
+  case BRANCH_MISSES: return "branch_misses";
+  }
+  return "";
+}
+
+bool PerfCounters::enable() {
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.lock);
+  closeAll(s);
+  s.error.clear();
+#ifdef __linux__
+  // The calling thread decides which events are counted
+  if(!openGroup(s, static_cast<pid_t>(syscall(SYS_gettid)), true)) {
+    if(s.error.empty()) s.error = "no event can be counted";
+    closeAll(s);
+    return false;
+  }
+  s.pid = getpid();
+  attach(s);
+  return true;
+#else
+  s.error = "not supported on this system";
+  return false;
+#endif
+}
+
+void PerfCounters::disable() {
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.lock);
+  closeAll(s);
+}
+
+bool PerfCounters::enabled() {
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.lock);
+  // Counters of a parent process are not those of a forked one
+  return s.pid && s.pid == getpid();
+}
+
+bool PerfCounters::counted(Event e) {
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.lock);
+  return s.pid == getpid() && s.counted[e];
+}
+
+std::string PerfCounters::error() {
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.lock);
+  return s.error;
+}
+
+PerfCounters::Values PerfCounters::read() {
+  Values ret{};
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.lock);
+  if(!s.pid || s.pid != getpid()) return ret;
+#ifdef __linux__
+  auto alive = attach(s);
+  // nr, time enabled, time running, then a value per event of the group
+  std::uint64_t buffer[3+events];
+  for(auto t = s.threads.begin(); t != s.threads.end();) {
+    auto& fds = t->second.fds;
+    auto leader = -1;
+    for(auto fd : fds) {
+      if(fd >= 0) {
+	leader = fd;
+	break;
+      }
+    }
+    Values counts{};
+    auto n = ::read(leader, buffer, sizeof(buffer));
+    if(n >= static_cast<ssize_t>(3*sizeof(std::uint64_t)) && buffer[2]) {
+      auto scale = static_cast<double>(buffer[1])/buffer[2];
+      auto v = 3u;
+      for(auto e = 0u; e < events && v < 3+buffer[0]; e++) {
+	if(fds[e] >= 0)
+	  counts[e] = buffer[v++]*scale;
+      }
+    }
+    // Counts of an ended thread are final: they are kept, its counters
+    // closed
+    auto& sum = alive.count(t->first) ? ret : s.ended;
+    for(auto e = 0u; e < events; e++) {
+      sum[e] += counts[e];
+    }
+    if(alive.count(t->first)) {
+      t++;
+      continue;
+    }
+    for(auto fd : fds) {
+      if(fd >= 0) close(fd);
+    }
+    t = s.threads.erase(t);
+  }
+  for(auto e = 0u; e < events; e++) {
+    ret[e] += s.ended[e];
+  }
+#endif
+  return ret;
+}
@@ -0,0 +1,102 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file PerfCounters.h
+ * \brief PerfCounters class header.
+ * \author Florian Galinier
+ * \version 0.1
+ * \date 19/10/26
+ *
+ * Hardware performance counters of the process (perf_event_open).
+ *
+ */
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <string>
+
+/**
+ * \class PerfCounters
+ * \brief Cycles, instructions, cache misses and branch misses of every
+ * thread of the process.
+ *
+ * Once enabled, a group of counters is opened for each thread of the
+ * process (user space only, as allowed by the default
+ * perf_event_paranoid), and threads started later are counted from the
+ * first read() they are alive at: a thread that starts and ends
+ * between two reads is not counted (pool workers live as long as the
+ * process). Values are the sums over threads, scaled when the kernel
+ * multiplexes the counters; counters of ended threads are closed by
+ * read(), and their last counts kept.
+ *
+ * Counting is optional: enable() fails when the kernel forbids it or
+ * the processor has no counter, and events that can not be counted
+ * are left out.
+ *
+ * \author Florian Galinier
+ */
+class PerfCounters {
+ public:
+  /**
+   * \brief Counted event.
+   */
+  enum Event {
+    CYCLES,
+    INSTRUCTIONS,
+    CACHE_MISSES,
+    BRANCH_MISSES
+  };
+  static const size_t events = 4;
+  typedef std::array<double,events> Values;
+  /**
+   * Return the name of an event (as a column name).
+   * \param e The event.
+   * \return The name.
+   */
+  static const char* name(Event e);
+  /**
+   * Open the counters of every thread of the process (again if they
+   * were).
+   * \return True if at least one event is counted, else see error().
+   */
+  static bool enable();
+  /**
+   * Close the counters.
+   */
+  static void disable();
+  /**
+   * Return true if counters are enabled (in this process).
+   * \return True if enabled.
+   */
+  static bool enabled();
+  /**
+   * Return true if an event is counted.
+   * \param e The event.
+   * \return True if counted.
+   */
+  static bool counted(Event e);
+  /**
+   * Return the reason of the last failure of enable().
+   * \return The reason, empty if none.
+   */
+  static std::string error();
+  /**
+   * Return the counts since enable() of every thread counted (see
+   * above), and start counting threads started since the last call.
+   * \return The counts, zero for events not counted.
+   */
+  static Values read();
+};
@@ -0,0 +1,302 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Probes.h"
+#include "Format.h"
+#include "Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <unistd.h>
+
+namespace {
+  struct Slots;
+
+  /* Span of a timer */
+  struct Event {
+    size_t probe;
+    size_t thread;
+    Probes::Clock::time_point start;
+    Probes::Clock::time_point end;
+  };
+
+  struct Registry {
+    std::mutex lock;
+    std::vector<Probes::Entry> entries;
+    std::map<std::string,size_t> index;
+    std::vector<Slots*> threads;
+    size_t nextThread = 0;
+    /* Trace file, events not written yet, names of threads (written
+       before their first event in the file) */
+    std::string trace;
+    Probes::Clock::time_point traceStart;
+    std::vector<Event> events;
+    std::map<size_t,std::string> names;
+    std::set<size_t> named;
+  };
+
+  std::atomic<bool> tracing(false);
+
+  /* Never destroyed: threads may end after static destructors */
+  Registry& registry() {
+    static auto r = new Registry();
+    return *r;
+  }
+
+  /* Values recorded by a thread since the last merge. The lock is only
+     contended while merging. */
+  struct Slots {
+    std::mutex lock;
+    std::vector<Probes::Stat> stats;
+    std::vector<Event> events;
+    size_t thread;
+    Slots() {
+      auto& r = registry();
+      std::lock_guard<std::mutex> guard(r.lock);
+      thread = r.nextThread++;
+      r.names[thread] = "thread "+std::to_string(thread);
+      r.threads.push_back(this);
+    }
+    ~Slots() {
+      auto& r = registry();
+      std::lock_guard<std::mutex> guard(r.lock);
+      fold(r);
+      r.threads.erase(std::find(r.threads.begin(), r.threads.end(), this));
+    }
+    /* Move values into the totals (the registry lock must be held) */
+    void fold(Registry& r) {
+      std::lock_guard<std::mutex> guard(lock);
+      for(auto i = 0u; i < stats.size(); i++) {
+	if(stats[i].count) {
+	  r.entries[i].stat.merge(stats[i]);
+	  stats[i] = Probes::Stat();
+	}
+      }
+      r.events.insert(r.events.end(), events.begin(), events.end());
+      events.clear();
+    }
+  };
+
+  Slots& slots() {
+    thread_local Slots s;
+    return s;
+  }
+
+  void appendName(std::string& s, const std::string& name) {
+    s += '"';
+    for(auto c : name) {
+      if(c == '"' || c == '\\') s += '\\';
+      s += c;
+    }
+    s += '"';
+  }
+
+  /* Write pending events (the registry lock must be held) */
+  void writeEvents(Registry& r) {
+    if(r.events.empty()) return;
+    std::string out;
+    out.reserve(r.events.size()*96);
+    auto pid = static_cast<long long>(getpid());
+    auto us = [&r](Probes::Clock::time_point t) {
+      return std::chrono::duration<double,std::micro>(t-r.traceStart).count();
+    };
+    for(auto& e : r.events) {
+      if(r.named.insert(e.thread).second) {
+	out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":";
+	Format::appendInteger(out, pid);
+	out += ",\"tid\":";
+	Format::appendInteger(out, e.thread);
+	out += ",\"args\":{\"name\":";
+	appendName(out, r.names[e.thread]);
+	out += "}},\n";
+      }
+      out += "{\"name\":";
+      appendName(out, r.entries[e.probe].name);
+      out += ",\"cat\":\"mdea\",\"ph\":\"X\",\"ts\":";
+      Format::appendFixed(out, us(e.start));
+      out += ",\"dur\":";
+      Format::appendFixed(out, us(e.end)-us(e.start));
+      out += ",\"pid\":";
+      Format::appendInteger(out, pid);
+      out += ",\"tid\":";
+      Format::appendInteger(out, e.thread);
+      out += "},\n";
+    }
+    r.events.clear();
+    Logger l(r.trace, std::ios_base::app);
+    l << out;
+  }
+}
+
+/* Stat */
+
+Probes::Stat::Stat(): count(0), sum(0), min(std::numeric_limits<double>::max()),
+		      max(-std::numeric_limits<double>::max()), histogram() {}
+
+void Probes::Stat::add(double v) {
+  count++;
+  sum += v;
+  min = (v < min) ? v : min;
+  max = (v > max) ? v : max;
+  auto b = 0;
+  if(v > 0)
+    b = std::max(0, std::min(static_cast<int>(buckets)-1,
+			     static_cast<int>(std::floor(std::log2(v)))+33));
+  histogram[b]++;
+}
+
+void Probes::Stat::merge(const Stat& s) {
+  count += s.count;
+  sum += s.sum;
+  min = (s.min < min) ? s.min : min;
+  max = (s.max > max) ? s.max : max;
+  for(auto b = 0u; b < buckets; b++) {
+    histogram[b] += s.histogram[b];
+  }
+}
+
+double Probes::Stat::mean() const {
+  return count ? sum/count : 0;
+}
+
+double Probes::Stat::quantile(double q) const {
+  if(!count) return 0;
+  auto rank = static_cast<size_t>(std::ceil(q*count));
+  if(!rank) return min;
+  size_t seen = 0;
+  for(auto b = 0u; b < buckets; b++) {
+    seen += histogram[b];
+    if(seen >= rank)
+      return std::min(max, std::ldexp(1.0, static_cast<int>(b)-32));
+  }
+  return max;
+}
+
+/* Registry */
+
+size_t Probes::probe(const std::string& name, Kind kind) {
+  auto& r = registry();
+  std::lock_guard<std::mutex> guard(r.lock);
+  auto it = r.index.find(name);
+  if(it != r.index.end())
+    return it->second;
+  r.entries.push_back({name, kind, Stat()});
+  return r.index[name] = r.entries.size()-1;
+}
+
+void Probes::record(size_t probe, double v) {
+  auto& s = slots();
+  std::lock_guard<std::mutex> guard(s.lock);
+  if(probe >= s.stats.size())
+    s.stats.resize(probe+1);
+  s.stats[probe].add(v);
+}
+
+void Probes::span(size_t probe, Clock::time_point start, Clock::time_point end) {
+  auto& s = slots();
+  std::lock_guard<std::mutex> guard(s.lock);
+  if(probe >= s.stats.size())
+    s.stats.resize(probe+1);
+  s.stats[probe].add(std::chrono::duration<double,std::milli>(end-start).count());
+  if(tracing)
+    s.events.push_back({probe, s.thread, start, end});
+}
+
+void Probes::merge() {
+  auto& r = registry();
+  std::lock_guard<std::mutex> guard(r.lock);
+  for(auto t : r.threads) {
+    t->fold(r);
+  }
+  if(tracing)
+    writeEvents(r);
+  else r.events.clear();
+}
+
+void Probes::trace(const std::string& path) {
+  auto& main = slots();
+  auto& r = registry();
+  std::lock_guard<std::mutex> guard(r.lock);
+  r.names[main.thread] = "main";
+  r.trace = path;
+  r.traceStart = Clock::now();
+  r.events.clear();
+  r.named.clear();
+  {
+    Logger l(path);
+    l << "[\n";
+  }
+  tracing = true;
+}
+
+void Probes::endTrace() {
+  if(!tracing) return;
+  merge();
+  auto& r = registry();
+  std::lock_guard<std::mutex> guard(r.lock);
+  tracing = false;
+  // The last element has no trailing comma
+  Logger l(r.trace, std::ios_base::app);
+  l << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":"
+    << std::to_string(getpid()) << ",\"args\":{\"name\":\"mdea\"}}\n]\n";
+}
+
+std::vector<Probes::Entry> Probes::totals() {
+  auto& r = registry();
+  std::lock_guard<std::mutex> guard(r.lock);
+  return r.entries;
+}
+
+void Probes::reset() {
+  auto& r = registry();
+  std::lock_guard<std::mutex> guard(r.lock);
+  for(auto t : r.threads) {
+    std::lock_guard<std::mutex> g(t->lock);
+    t->stats.clear();
+    t->events.clear();
+  }
+  r.events.clear();
+  for(auto& e : r.entries) {
+    e.stat = Stat();
+  }
+}
+
+std::string Probes::summary() {
+  std::ostringstream os;
+  os << std::left << std::setw(28) << "probe" << std::right
+     << std::setw(10) << "count" << std::setw(13) << "total"
+     << std::setw(11) << "mean" << std::setw(11) << "min"
+     << std::setw(11) << "p50" << std::setw(11) << "p90"
+     << std::setw(11) << "max" << "\n";
+  os << std::fixed << std::setprecision(3);
+  for(auto& e : totals()) {
+    auto& s = e.stat;
+    if(!s.count) continue;
+    os << std::left << std::setw(28)
+       << (e.name + ((e.kind == TIMER) ? " (ms)" : "")) << std::right
+       << std::setw(10) << s.count << std::setw(13) << s.sum;
+    if(e.kind != COUNTER)
+      os << std::setw(11) << s.mean() << std::setw(11) << s.min
+	 << std::setw(11) << s.quantile(0.5) << std::setw(11) << s.quantile(0.9)
+	 << std::setw(11) << s.max;
+    os << "\n";
+  }
+  return os.str();
+}
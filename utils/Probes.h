@@ -0,0 +1,236 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file Probes.h
+ * \brief Probes class header.
+ * \author Florian Galinier
+ * \version 0.1
+ * \date 19/10/26
+ *
+ * Named timers, counters and histograms of hot paths.
+ *
+ */
+
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * \class Probes
+ * \brief Registry of named probes.
+ *
+ * A probe is registered once by name and then identified by its
+ * number. Values are recorded in a slot of the calling thread, without
+ * contention; merge() folds the slots of every thread into the totals
+ * (NSGAII does it at the end of each generation). Slots of a thread
+ * that ends are folded at its end.
+ *
+ * Code is instrumented through the PROBE_* macros, which compile to
+ * nothing with NO_PROBES. Spans of timers can also be traced (see
+ * trace()) to be viewed on a timeline (chrome://tracing, Perfetto).
+ *
+ * \author Florian Galinier
+ */
+class Probes {
+ public:
+  /**
+   * \brief Kind of probe.
+   * A timer records durations (ms), a counter increments, a histogram
+   * any value.
+   */
+  enum Kind {
+    TIMER,
+    COUNTER,
+    HISTOGRAM
+  };
+  /**
+   * \brief Summary of recorded values: count, sum, extrema and a
+   * histogram of powers of 2.
+   */
+  struct Stat {
+    /**
+     * Number of buckets; bucket b holds values in [2^(b-33),2^(b-32)),
+     * bucket 0 values below 2^-32 (and non positive values).
+     */
+    static const size_t buckets = 64;
+    size_t count;
+    double sum;
+    double min;
+    double max;
+    std::array<size_t,buckets> histogram;
+    Stat();
+    /**
+     * Record a value.
+     * \param v The value.
+     */
+    void add(double v);
+    /**
+     * Record the values of another summary.
+     * \param s The other summary.
+     */
+    void merge(const Stat& s);
+    /**
+     * Return the average value (0 if none).
+     * \return The average.
+     */
+    double mean() const;
+    /**
+     * Return an upper bound of a quantile, from the histogram.
+     * \param q The quantile, in [0,1].
+     * \return The upper bound of the bucket of the quantile (bounded
+     * by max), min for 0.
+     */
+    double quantile(double q) const;
+  };
+  /**
+   * \brief Totals of a probe.
+   */
+  struct Entry {
+    std::string name;
+    Kind kind;
+    Stat stat;
+  };
+  typedef std::chrono::steady_clock Clock;
+  /**
+   * \brief Scoped timer: records the duration of its scope (and a trace
+   * event if tracing).
+   */
+  class Timer {
+    size_t probe;
+    Clock::time_point start;
+   public:
+    Timer(size_t probe): probe(probe), start(Clock::now()) {}
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+    ~Timer() {
+      Probes::span(probe, start, Clock::now());
+    }
+  };
+  /**
+   * Return the number of a probe, registered at first call.
+   * \param name The name of the probe.
+   * \param kind The kind of the probe.
+   * \return The number of the probe.
+   */
+  static size_t probe(const std::string& name, Kind kind);
+  /**
+   * Record a value in the slot of the calling thread.
+   * \param probe The number of the probe.
+   * \param v The value (duration in ms for a timer, increment for a
+   * counter).
+   */
+  static void record(size_t probe, double v);
+  /**
+   * Record the duration (ms) of a span of the calling thread in a
+   * timer, and a trace event if tracing.
+   * \param probe The number of the timer.
+   * \param start The start of the span.
+   * \param end The end of the span.
+   */
+  static void span(size_t probe, Clock::time_point start, Clock::time_point end);
+  /**
+   * Start writing the spans of timers to a trace file (Chrome
+   * trace-event format, JSON array of complete events: one per span,
+   * with the thread that recorded it). Events are written at merge().
+   * \param path The trace file path.
+   */
+  static void trace(const std::string& path);
+  /**
+   * Write pending events and end the trace file (no effect if not
+   * tracing).
+   */
+  static void endTrace();
+  /**
+   * Fold the slots of every thread into the totals, and write their
+   * trace events.
+   */
+  static void merge();
+  /**
+   * Return the totals of every probe (values recorded since the last
+   * merge are not included), in registration order.
+   * \return The totals.
+   */
+  static std::vector<Entry> totals();
+  /**
+   * Clear slots and totals (probes stay registered).
+   */
+  static void reset();
+  /**
+   * Return a table of the totals of every recorded probe.
+   * \return The table (with end of lines).
+   */
+  static std::string summary();
+};
+
+#ifndef NO_PROBES
+#define PROBE_CAT2(a,b) a##b
+#define PROBE_CAT(a,b) PROBE_CAT2(a,b)
+/**
+ * Time the rest of the enclosing scope.
+ */
+#define PROBE_TIMER(name)						\
+  static const size_t PROBE_CAT(probeId,__LINE__) =			\
+    Probes::probe(name, Probes::TIMER);					\
+  Probes::Timer PROBE_CAT(probeTimer,__LINE__)(PROBE_CAT(probeId,__LINE__))
+/**
+ * Time the span from a time point (Probes::Clock) to now.
+ */
+#define PROBE_SPAN(name,start) do {					\
+    static const size_t probeId = Probes::probe(name, Probes::TIMER);	\
+    Probes::span(probeId, (start), Probes::Clock::now());		\
+  } while(0)
+/**
+ * Time the span from a time point (Probes::Clock, a variable) to now,
+ * and return its duration (ms); the time point becomes now, the start
+ * of the next span.
+ */
+#define PROBE_LAP(name,t) [&]() {					\
+    static const size_t probeId = Probes::probe(name, Probes::TIMER);	\
+    auto probeEnd = Probes::Clock::now();				\
+    Probes::span(probeId, (t), probeEnd);				\
+    auto probeMs = std::chrono::duration<double,std::milli>(probeEnd-(t)).count(); \
+    (t) = probeEnd;							\
+    return probeMs;							\
+  }()
+/**
+ * Increment a counter.
+ */
+#define PROBE_COUNT(name,n) do {					\
+    static const size_t probeId = Probes::probe(name, Probes::COUNTER); \
+    Probes::record(probeId, (n));					\
+  } while(0)
+/**
+ * Record a value in a histogram.
+ */
+#define PROBE_VALUE(name,v) do {					\
+    static const size_t probeId = Probes::probe(name, Probes::HISTOGRAM); \
+    Probes::record(probeId, (v));					\
+  } while(0)
+#else
+/* Values are not evaluated (sizeof only keeps them used) */
+#define PROBE_TIMER(name) do {} while(0)
+#define PROBE_SPAN(name,start) do { (void)sizeof(start); } while(0)
+#define PROBE_LAP(name,t) [&]() {					\
+    auto probeEnd = Probes::Clock::now();				\
+    auto probeMs = std::chrono::duration<double,std::milli>(probeEnd-(t)).count(); \
+    (t) = probeEnd;							\
+    return probeMs;							\
+  }()
+#define PROBE_COUNT(name,n) do { (void)sizeof(n); } while(0)
+#define PROBE_VALUE(name,v) do { (void)sizeof(v); } while(0)
+#endif
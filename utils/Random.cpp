@@ -0,0 +1,133 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Random.h"
+#include <chrono>
+#include <random>
+
+namespace {
+  /* splitmix64, used to expand keys into xoshiro states */
+  uint64_t splitmix(uint64_t& x) {
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+
+  /* Stream bound by the innermost Scope of the thread (if any) */
+  thread_local Random* bound = nullptr;
+}
+
+uint64_t Random::runSeed = 0x4d444541ULL;
+
+/* Constructors */
+
+Random::Random(uint64_t purpose, uint64_t gen, uint64_t index, uint64_t sub) {
+  // Each key component is mixed in turn so that close keys give
+  // unrelated states.
+  uint64_t x = runSeed;
+  for(auto k : {purpose, gen, index, sub}) {
+    x ^= splitmix(x) + k;
+  }
+  for(auto& w : s) {
+    w = splitmix(x);
+  }
+}
+
+/* Generation */
+
+uint64_t Random::next() {
+  auto res = rotl(s[1] * 5, 7) * 9;
+  auto t = s[1] << 17;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl(s[3], 45);
+  return res;
+}
+
+int Random::nextInt(int low, int high) {
+  if(high <= low) return low;
+  uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(high) - low) + 1;
+  // Rejection sampling to avoid modulo bias
+  uint64_t limit = UINT64_MAX - (UINT64_MAX % range);
+  uint64_t r;
+  do {
+    r = next();
+  } while(r >= limit);
+  return static_cast<int>(low + static_cast<int64_t>(r % range));
+}
+
+float Random::nextFloat(float low, float high) {
+  // 24 high bits give every representable float of [0,1)
+  auto u = (next() >> 40) * (1.0f / 16777216.0f);
+  return low + u * (high - low);
+}
+
+/* Run seed */
+
+void Random::seed(uint64_t seed) {
+  runSeed = seed;
+}
+
+uint64_t Random::seed() {
+  return runSeed;
+}
+
+uint64_t Random::makeSeed() {
+  std::random_device rd;
+  uint64_t x = std::chrono::high_resolution_clock::now()
+    .time_since_epoch().count();
+  x ^= (static_cast<uint64_t>(rd()) << 32) | rd();
+  return splitmix(x);
+}
+
+/* Thread streams */
+
+Random& Random::current() {
+  if(bound) return *bound;
+  // Without scope, a thread uses the default stream of the
+  // current run seed.
+  thread_local Random fallback;
+  thread_local uint64_t fallbackSeed = runSeed;
+  if(fallbackSeed != runSeed) {
+    fallback = Random();
+    fallbackSeed = runSeed;
+  }
+  return fallback;
+}
+
+int Random::randomInt(int low, int high) {
+  return current().nextInt(low, high);
+}
+
+float Random::randomFloat(float low, float high) {
+  return current().nextFloat(low, high);
+}
+
+Random::Scope::Scope(uint64_t purpose, uint64_t gen, uint64_t index,
+		     uint64_t sub): rng(purpose, gen, index, sub),
+				    previous(bound) {
+  bound = &rng;
+}
+
+Random::Scope::~Scope() {
+  bound = previous;
+}
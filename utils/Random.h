@@ -0,0 +1,153 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file Random.h
+ * \brief Random class header.
+ * \author Florian Galinier
+ * \version 0.1
+ * \date 19/10/26
+ *
+ * Seeded random number streams (xoshiro256**) derived from a single
+ * run seed.
+ *
+ */
+
+#pragma once
+#include <cstdint>
+
+/**
+ * \class Random
+ * \brief A xoshiro256** random stream.
+ *
+ * Every stream is derived from the run seed and a key (purpose,
+ * generation, index). A key identifies a logical task (e.g. the k-th
+ * crossover of a generation) rather than a thread, so results do not
+ * depend on which thread executes the task nor on the number of threads.
+ *
+ * Random::randomInt and Random::randomFloat draw from the stream bound
+ * to the calling thread by a Random::Scope.
+ *
+ * \author Florian Galinier
+ */
+class Random {
+ private:
+  uint64_t s[4];
+  static uint64_t runSeed;
+ public:
+  /**
+   * \brief Purpose of a stream.
+   * Used as first component of the stream key.
+   */
+  enum Stream {
+    DEFAULT    = 0,
+    CROSSOVER  = 1,
+    MUTATION   = 2,
+    CLUSTERING = 3,
+    REPAIR     = 4,
+  };
+  /**
+   * Create the stream identified by the given key.
+   * \param purpose The purpose of the stream.
+   * \param gen The generation of the stream.
+   * \param index The index of the task in the generation.
+   * \param sub An optional sub-index (e.g. retry number).
+   */
+  Random(uint64_t purpose = DEFAULT, uint64_t gen = 0,
+	 uint64_t index = 0, uint64_t sub = 0);
+  /**
+   * Return the next 64 bits of the stream.
+   * \return A uniformly distributed 64 bits integer.
+   */
+  uint64_t next();
+  /**
+   * Return an integer in [low,high].
+   * \param low Lower bound (included).
+   * \param high Upper bound (included).
+   * \return A uniformly distributed integer.
+   */
+  int nextInt(int low, int high);
+  /**
+   * Return a float in [low,high).
+   * \param low Lower bound.
+   * \param high Upper bound.
+   * \return A uniformly distributed float.
+   */
+  float nextFloat(float low, float high);
+  /**
+   * Change the run seed. Streams created before the call are
+   * not affected.
+   * \param seed The new run seed.
+   */
+  static void seed(uint64_t seed);
+  /**
+   * Return the run seed.
+   * \return The run seed.
+   */
+  static uint64_t seed();
+  /**
+   * Return a seed built from the clock and the random device.
+   * \return A new seed.
+   */
+  static uint64_t makeSeed();
+  /**
+   * Return the stream bound to the calling thread.
+   * \return The current stream.
+   */
+  static Random& current();
+  /**
+   * Return an integer in [low,high] from the current stream.
+   * \param low Lower bound (included).
+   * \param high Upper bound (included).
+   * \return A uniformly distributed integer.
+   */
+  static int randomInt(int low, int high);
+  /**
+   * Return a float in [low,high) from the current stream.
+   * \param low Lower bound.
+   * \param high Upper bound.
+   * \return A uniformly distributed float.
+   */
+  static float randomFloat(float low, float high);
+
+  class Scope;
+};
+
+/**
+ * \class Random::Scope
+ * \brief Bind a stream to the calling thread for the scope lifetime.
+ *
+ * The previously bound stream is restored on destruction.
+ */
+class Random::Scope {
+ private:
+  Random rng;
+  Random* previous;
+ public:
+  /**
+   * Bind the stream identified by the given key.
+   * \param purpose The purpose of the stream.
+   * \param gen The generation of the stream.
+   * \param index The index of the task in the generation.
+   * \param sub An optional sub-index (e.g. retry number).
+   */
+  Scope(uint64_t purpose, uint64_t gen, uint64_t index = 0,
+	  uint64_t sub = 0);
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+  /**
+   * Restore previous stream.
+   */
+  ~Scope() noexcept;
+};
@@ -0,0 +1,70 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Scratch.h"
+#include "Directory.h"
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+  /* Scratch directory, removed by the process that created it */
+  struct ScratchDirectory {
+    std::string path;
+    pid_t owner;
+    ScratchDirectory(): owner(getpid()) {
+      auto tmp = getenv("TMPDIR");
+      std::string pattern = std::string(tmp && *tmp ? tmp : "/tmp")+"/mdea-XXXXXX";
+      std::vector<char> name(pattern.begin(), pattern.end());
+      name.push_back('\0');
+      if(!mkdtemp(name.data()))
+	throw std::runtime_error("Could not create scratch directory "+pattern+".");
+      path = name.data();
+    }
+    ~ScratchDirectory() {
+      // Forked children share the directory but do not own it
+      if(getpid() == owner) Directory::remove(path);
+    }
+  };
+}
+
+/* Constructors */
+
+Scratch::Scratch(const std::string& suffix) {
+  std::string pattern = directory()+"/tmpXXXXXX"+suffix;
+  std::vector<char> name(pattern.begin(), pattern.end());
+  name.push_back('\0');
+  auto fd = mkstemps(name.data(), suffix.size());
+  if(fd < 0)
+    throw std::runtime_error("Could not create scratch file "+pattern+".");
+  close(fd);
+  filePath = name.data();
+}
+
+Scratch::~Scratch() {
+  unlink(filePath.c_str());
+}
+
+/* Accessors */
+
+const std::string& Scratch::path() const {
+  return filePath;
+}
+
+const std::string& Scratch::directory() {
+  static ScratchDirectory dir;
+  return dir.path;
+}
@@ -0,0 +1,70 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * \file Scratch.h
+ * \brief Scratch class header.
+ * \author Florian Galinier
+ * \version 0.1
+ * \date 19/10/26
+ *
+ * Private scratch files for external tools.
+ *
+ */
+
+#pragma once
+#include <string>
+
+/**
+ * \class Scratch
+ * \brief A unique scratch file, removed when the Scratch is destroyed.
+ *
+ * Scratch files are created in a directory private to the process
+ * (under $TMPDIR, or /tmp), removed at exit. Every evaluation gets its
+ * own file, so evaluations of a process, or processes sharing a working
+ * directory, do not overwrite each other's inputs.
+ *
+ * \author Florian Galinier
+ */
+class Scratch {
+ private:
+  std::string filePath;
+ public:
+  /**
+   * Create an empty scratch file.
+   * \param suffix The file name suffix (e.g. ".xml").
+   * \throw std::runtime_error if the file can not be created.
+   */
+  Scratch(const std::string& suffix = "");
+  Scratch(const Scratch&) = delete;
+  Scratch& operator=(const Scratch&) = delete;
+  /**
+   * Remove the scratch file.
+   */
+  virtual ~Scratch() noexcept;
+  /**
+   * Return the path of the scratch file.
+   * \return The file path.
+   */
+  const std::string& path() const;
+  /**
+   * Return the scratch directory of the process (created on first call).
+   * Forked processes use the one of their parent if it exists, so a
+   * parent should create it before forking processes that leave with
+   * _exit.
+   * \return The directory path.
+   */
+  static const std::string& directory();
+};
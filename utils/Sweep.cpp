@@ -0,0 +1,86 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Sweep.h"
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+  /* Options of the run name */
+  const std::vector<std::string> named =
+    {"-in","-cx","-dist","-fitness","-g","-m","-nb"};
+}
+
+std::vector<std::string> Sweep::explode(const std::string& s, char sep) {
+  std::vector<std::string> ret;
+  std::stringstream split(s);
+  std::string v;
+  while(std::getline(split,v,sep)) {
+    ret.push_back(v);
+  }
+  if(ret.empty()) ret.push_back("");
+  return ret;
+}
+
+std::vector<Sweep::Options> Sweep::expand(const Options& opt,
+					  const std::vector<std::string>& keys) {
+  std::vector<Options> configs = {opt};
+  for(auto& key : keys) {
+    std::vector<Options> next;
+    for(auto& c : configs) {
+      for(auto& v : explode(opt.at(key), ',')) {
+	next.push_back(c);
+	next.back()[key] = v;
+      }
+    }
+    configs = std::move(next);
+  }
+  return configs;
+}
+
+std::string Sweep::runName(const Options& opt) {
+  std::ostringstream dir;
+  dir << opt.at("-in") << "-" << opt.at("-cx") << "-" << opt.at("-dist") << "-" << opt.at("-fitness") << "-" << opt.at("-g") << "-" << opt.at("-m") << "-" << opt.at("-nb");
+  return dir.str();
+}
+
+std::vector<std::string> Sweep::names(const std::vector<Options>& configs,
+				      const std::vector<std::string>& keys) {
+  // Keys out of the run name are added when runs differ by them
+  std::vector<std::string> varying;
+  for(auto& key : keys) {
+    if(std::find(named.begin(), named.end(), key) != named.end()) continue;
+    for(auto& c : configs) {
+      if(c.at(key) != configs[0].at(key)) {
+	varying.push_back(key);
+	break;
+      }
+    }
+  }
+  std::vector<std::string> ret;
+  std::set<std::string> seen;
+  for(auto& c : configs) {
+    auto name = runName(c);
+    for(auto& key : varying) {
+      name += "-"+key.substr(1)+c.at(key);
+    }
+    std::replace(name.begin(), name.end(), '/', '_');
+    if(!seen.insert(name).second)
+      throw std::runtime_error("Several runs are named "+name+", a value is given twice.");
+    ret.push_back(name);
+  }
+  return ret;
+}
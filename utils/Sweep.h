@@ -0,0 +1,75 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file Sweep.h
+ * \brief Sweep class header.
+ * \author Florian Galinier
+ * \version 0.1
+ * \date 19/10/26
+ *
+ * Configurations and names of the runs of mdea sweep.
+ *
+ */
+
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * \class Sweep
+ * \brief Expansion of options with comma separated values into run
+ * configurations, and names of these runs.
+ *
+ * \author Florian Galinier
+ */
+class Sweep {
+ public:
+  typedef std::map<std::string,std::string> Options;
+  /**
+   * Split a value on a separator.
+   * \param s The value.
+   * \param sep The separator.
+   * \return The parts, a single empty one for an empty value.
+   */
+  static std::vector<std::string> explode(const std::string& s, char sep);
+  /**
+   * Return every combination of the comma separated values of options.
+   * \param opt The options.
+   * \param keys The options whose values are combined (they must be in
+   * opt).
+   * \return The configurations, the first key varying slowest.
+   */
+  static std::vector<Options> expand(const Options& opt,
+				     const std::vector<std::string>& keys);
+  /**
+   * Return the name of a run, <in>-<cx>-<dist>-<fitness>-<g>-<m>-<nb>.
+   * \param opt The options of the run.
+   * \return The name.
+   */
+  static std::string runName(const Options& opt);
+  /**
+   * Return the names of the runs of a sweep, single file names: the run
+   * name, followed by -<key><value> for every other key whose value
+   * differs between configurations.
+   * \param configs The configurations.
+   * \param keys The keys of the sweep.
+   * \return The names, in the order of configurations.
+   * \throw std::runtime_error If two configurations have the same name
+   * (a value given twice).
+   */
+  static std::vector<std::string> names(const std::vector<Options>& configs,
+					const std::vector<std::string>& keys);
+};
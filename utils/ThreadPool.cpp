@@ -0,0 +1,128 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <unistd.h>
+
+namespace {
+  /* Number of workers of the next pool started by instance() */
+  std::atomic<size_t> instanceThreads(0);
+}
+
+/* Constructors */
+
+ThreadPool::ThreadPool(size_t threads): stopping(false) {
+  if(!threads) threads = std::thread::hardware_concurrency();
+  if(!threads) threads = 1;
+  for(auto i = 0u; i < threads; i++) {
+    workers.emplace_back(&ThreadPool::run, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    stopping = true;
+  }
+  wake.notify_all();
+  for(auto& w : workers) {
+    w.join();
+  }
+}
+
+ThreadPool& ThreadPool::instance() {
+  static ThreadPool pool(instanceThreads);
+  static const pid_t owner = getpid();
+  if(getpid() == owner) return pool;
+  // Workers do not survive fork: a forked process starts its own pool
+  // (the copy of the parent one is left as is, never destroyed)
+  static std::mutex forkLock;
+  static ThreadPool* forked = nullptr;
+  static pid_t forkedPid = 0;
+  std::lock_guard<std::mutex> guard(forkLock);
+  if(forkedPid != getpid()) {
+    forked = new ThreadPool(instanceThreads);
+    forkedPid = getpid();
+  }
+  return *forked;
+}
+
+void ThreadPool::instanceSize(size_t threads) {
+  instanceThreads = threads;
+}
+
+size_t ThreadPool::size() const {
+  return workers.size();
+}
+
+/* Workers */
+
+void ThreadPool::run() {
+  while(true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> l(lock);
+      wake.wait(l, [this] { return stopping || !tasks.empty(); });
+      if(tasks.empty()) return;
+      task = std::move(tasks.front());
+      tasks.pop_front();
+    }
+    task();
+  }
+}
+
+void ThreadPool::parallelFor(size_t n, const std::function<void(size_t)>& task) {
+  if(!n) return;
+  // Iterations are claimed one by one by helpers and by the caller
+  struct Loop {
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> finished{0};
+    std::mutex lock;
+    std::condition_variable done;
+    std::exception_ptr error;
+  };
+  auto loop = std::make_shared<Loop>();
+  auto body = [loop,n,&task]() {
+    size_t i, nb = 0;
+    while((i = loop->next++) < n) {
+      try {
+	task(i);
+      } catch(...) {
+	std::lock_guard<std::mutex> guard(loop->lock);
+	if(!loop->error) loop->error = std::current_exception();
+      }
+      nb++;
+    }
+    if(nb && (loop->finished += nb) == n) {
+      std::lock_guard<std::mutex> guard(loop->lock);
+      loop->done.notify_all();
+    }
+  };
+  auto helpers = std::min(workers.size(), n-1);
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    for(auto k = 0u; k < helpers; k++) {
+      tasks.push_back(body);
+    }
+  }
+  wake.notify_all();
+  body();
+  std::unique_lock<std::mutex> l(loop->lock);
+  loop->done.wait(l, [&loop,n] { return loop->finished == n; });
+  if(loop->error) std::rethrow_exception(loop->error);
+}
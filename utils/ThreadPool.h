@@ -0,0 +1,91 @@
+/*
+ * This file is part of MDEA.
+ * MDEA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * MDEA is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MDEA.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file ThreadPool.h
+ * \brief ThreadPool class header.
+ * \author Florian Galinier
+ * \version 0.1
+ * \date 19/10/26
+ *
+ * A fixed set of worker threads running indexed tasks.
+ *
+ */
+
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * \class ThreadPool
+ * \brief Worker threads shared by parallel loops.
+ *
+ * \author Florian Galinier
+ */
+class ThreadPool {
+ private:
+  std::vector<std::thread> workers;
+  std::deque<std::function<void()>> tasks;
+  std::mutex lock;
+  std::condition_variable wake;
+  bool stopping;
+  /**
+   * Worker loop.
+   */
+  void run();
+ public:
+  /**
+   * Start a pool.
+   * \param threads The number of workers (0 for the number of cores).
+   */
+  ThreadPool(size_t threads = 0);
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  /**
+   * Finish queued tasks and stop workers.
+   */
+  virtual ~ThreadPool() noexcept;
+  /**
+   * Return the pool of the process. A forked process gets a new pool,
+   * and must leave with _exit (the copy of the parent pool can not be
+   * destroyed).
+   * \return The shared pool.
+   */
+  static ThreadPool& instance();
+  /**
+   * Set the number of workers of the pool of the process, when it is
+   * not started yet (a forked process starts its own pool, so it can
+   * set it before using instance()).
+   * \param threads The number of workers (0 for the number of cores).
+   */
+  static void instanceSize(size_t threads);
+  /**
+   * Return the number of workers.
+   * \return The number of workers.
+   */
+  size_t size() const;
+  /**
+   * Run task(i) for every i in [0,n) and wait for completion. The
+   * calling thread takes part in the loop, so nested calls do not
+   * deadlock. The first exception thrown by a task is rethrown.
+   * \param n The number of iterations.
+   * \param task The task to run.
+   */
+  void parallelFor(size_t n, const std::function<void(size_t)>& task);
+};